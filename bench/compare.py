@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Compare two skiaplot_bench JSON runs and flag regressions.
+
+Usage: compare.py BASELINE.json CURRENT.json [--threshold PERCENT] [--min-ms MS]
+
+Cases are matched by name and compared on their median time. A case is a
+regression when it is slower than the baseline by more than the threshold
+(default 10%) and by more than --min-ms (default 0.05 ms, which keeps
+timer noise on tiny cases out). Exits with status 1 if any case regressed.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return {r["name"]: r for r in data["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed slowdown in percent (default 10)")
+    parser.add_argument("--min-ms", type=float, default=0.05,
+                        help="ignore differences below this many ms (default 0.05)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    print(f"{'case':<44}{'baseline':>12}{'current':>12}{'change':>10}")
+    for name, result in current.items():
+        if name not in baseline:
+            print(f"{name:<44}{'-':>12}{result['median_ms']:>12.3f}{'new':>10}")
+            continue
+
+        before = baseline[name]["median_ms"]
+        after = result["median_ms"]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold and after - before > args.min_ms:
+            flag = "  REGRESSION"
+            regressions += 1
+        elif change < -args.threshold and before - after > args.min_ms:
+            flag = "  faster"
+        print(f"{name:<44}{before:>12.3f}{after:>12.3f}{change:>+9.1f}%{flag}")
+
+    for name in baseline:
+        if name not in current:
+            print(f"{name:<44}{baseline[name]['median_ms']:>12.3f}{'-':>12}{'missing':>10}")
+
+    if regressions:
+        print(f"\n{regressions} case(s) regressed by more than {args.threshold:g}%")
+        return 1
+    print("\nNo regressions")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
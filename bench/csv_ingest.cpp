@@ -0,0 +1,101 @@
+#include "skiaplot.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes a CSV file with an x column and two y columns
+static bool writeCsv(const std::string& path, int rows) {
+    std::mt19937 gen(42);
+    std::normal_distribution<> noise(0.0, 1.0);
+    
+    std::ofstream out(path);
+    out << "time,signal,reference\n" << std::setprecision(10);
+    for (int i = 0; i < rows; ++i) {
+        double t = i * 0.001;
+        out << t << ',' << noise(gen) << ',' << noise(gen) * 0.5 << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+// The usual hand-written reader: getline, a stringstream per row, and
+// addPoint row by row
+static size_t readNaive(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    
+    SkiaPlot::DataSeries signal("signal");
+    SkiaPlot::DataSeries reference("reference");
+    while (std::getline(in, line)) {
+        std::istringstream row(line);
+        std::string field;
+        double values[3] = {0.0, 0.0, 0.0};
+        for (int i = 0; i < 3 && std::getline(row, field, ','); ++i) {
+            values[i] = std::stod(field);
+        }
+        signal.addPoint(values[0], values[1]);
+        reference.addPoint(values[0], values[2]);
+    }
+    return signal.size();
+}
+
+static size_t readBuiltIn(const std::string& path, int threads) {
+    SkiaPlot::CsvOptions options;
+    options.threads = threads;
+    std::vector<SkiaPlot::DataSeries> series;
+    if (!SkiaPlot::readCsvFile(path, series, options)) {
+        return 0;
+    }
+    return series[0].size();
+}
+
+template <typename Fn>
+static void timeRead(const std::string& label, size_t bytes, Fn&& read) {
+    auto start = std::chrono::steady_clock::now();
+    size_t rows = read();
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+    
+    std::cout << std::setw(28) << std::left << label << std::right << std::setw(12)
+              << std::fixed << std::setprecision(1) << ms << std::setw(12)
+              << bytes / 1e6 / (ms / 1000.0) << std::setw(12) << rows << std::endl;
+}
+
+int main(int argc, char** argv) {
+    // Usage: csv_ingest [rows]
+    int rows = argc > 1 ? std::atoi(argv[1]) : 5000000;
+    const std::string path = "csv_ingest.csv";
+    
+    std::cout << "Writing " << rows << " rows to " << path << "..." << std::endl;
+    if (!writeCsv(path, rows)) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return 1;
+    }
+    std::ifstream probe(path, std::ios::binary | std::ios::ate);
+    size_t bytes = static_cast<size_t>(probe.tellg());
+    
+    std::cout << std::setw(28) << std::left << "reader" << std::right << std::setw(12) << "ms"
+              << std::setw(12) << "MB/s" << std::setw(12) << "rows" << std::endl;
+    
+    // The first read also pulls the file into the page cache
+    readBuiltIn(path, 1);
+    timeRead("iostream + addPoint", bytes, [&] { return readNaive(path); });
+    timeRead("readCsvFile, 1 thread", bytes, [&] { return readBuiltIn(path, 1); });
+    
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    if (cores > 1) {
+        timeRead("readCsvFile, " + std::to_string(cores) + " threads", bytes,
+                 [&] { return readBuiltIn(path, cores); });
+    }
+    
+    std::remove(path.c_str());
+    return 0;
+}
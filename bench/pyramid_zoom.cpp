@@ -0,0 +1,74 @@
+#include "skiaplot.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Renders the series at a sequence of zoom windows and returns the average
+// time per render in milliseconds
+static double timeZoom(SkiaPlot::Plot& plot, double xEnd, int steps) {
+    SkiaPlot::PlotConfig& config = plot.getConfig();
+    double total = 0.0;
+    for (int i = 0; i < steps; ++i) {
+        // Zoom in on the middle, halving the window every few steps
+        double width = xEnd / std::pow(2.0, i / 4.0);
+        config.xMin = xEnd / 2 - width / 2;
+        config.xMax = xEnd / 2 + width / 2;
+        
+        auto start = std::chrono::steady_clock::now();
+        plot.render();
+        total += std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start).count();
+    }
+    return total / steps;
+}
+
+int main(int argc, char** argv) {
+    // Usage: pyramid_zoom [points]
+    size_t numPoints = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+    const int steps = 40;
+    
+    std::cout << "Uniform-x series of " << numPoints << " float samples, " << steps
+              << " zoom steps at 1200x600" << std::endl;
+    
+    std::mt19937 gen(42);
+    std::normal_distribution<float> noise(0.0f, 0.1f);
+    std::vector<float> samples(numPoints);
+    for (size_t i = 0; i < numPoints; ++i) {
+        samples[i] = std::sin(i * 1e-5f) + noise(gen);
+    }
+    double xEnd = static_cast<double>(numPoints);
+    
+    SkiaPlot::DataSeries series("signal");
+    series.setUniformView(0.0, 1.0, samples);
+    
+    SkiaPlot::Plot plot(1200, 600);
+    SkiaPlot::PlotConfig& config = plot.getConfig();
+    config.showPoints = false;
+    config.lineWidth = 1.0f;
+    config.decimate = true;  // Pyramid queries serve decimated renders
+    config.yMin = -1.5;
+    config.yMax = 1.5;
+    
+    plot.addSeries(series);
+    double scanMs = timeZoom(plot, xEnd, steps);
+    
+    auto start = std::chrono::steady_clock::now();
+    series.buildPyramid();
+    double buildMs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start).count();
+    
+    plot.clearSeries();
+    plot.addSeries(series);
+    double pyramidMs = timeZoom(plot, xEnd, steps);
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Pyramid build:           " << buildMs << " ms" << std::endl;
+    std::cout << "Render without pyramid:  " << scanMs << " ms" << std::endl;
+    std::cout << "Render with pyramid:     " << pyramidMs << " ms" << std::endl;
+    
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "skiaplot.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImageInfo.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// Renders the plot several times and returns the fastest time in ms
+static double timeRender(SkiaPlot::Plot& plot, int repeats) {
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        plot.render();
+        double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ms);
+    }
+    return best;
+}
+
+static std::vector<uint32_t> readPixels(SkiaPlot::Plot& plot) {
+    const SkiaPlot::PlotConfig& config = plot.getConfig();
+    std::vector<uint32_t> pixels(static_cast<size_t>(config.width) * config.height);
+    SkImageInfo info = SkImageInfo::MakeN32Premul(config.width, config.height);
+    plot.getCanvas()->readPixels(info, pixels.data(), config.width * 4, 0, 0);
+    return pixels;
+}
+
+int main(int argc, char** argv) {
+    // Usage: render_scaling [points per series] [series] [repeats]
+    int numPoints = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int numSeries = argc > 2 ? std::atoi(argv[2]) : 12;
+    int repeats = argc > 3 ? std::atoi(argv[3]) : 5;
+    
+    std::cout << "Dashboard panel: " << numSeries << " series x " << numPoints
+              << " points, 1600x1000" << std::endl;
+    
+    SkiaPlot::Plot plot(1600, 1000);
+    SkiaPlot::PlotConfig& config = plot.getConfig();
+    config.showPoints = false;
+    config.lineWidth = 1.0f;
+    config.decimate = true;
+    config.title = "Render scaling";
+    config.incrementalRender = false;  // Time full redraws of unchanged data
+    
+    for (int s = 0; s < numSeries; ++s) {
+        SkiaPlot::DataSeries series("series " + std::to_string(s));
+        for (int i = 0; i < numPoints; ++i) {
+            double x = i * 0.001;
+            series.addPoint(x, s + std::sin(x * (s + 1)) + 0.3 * std::sin(x * 97.0));
+        }
+        plot.addSeries(series);
+    }
+    
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    
+    for (int tileHeight : {0, 64}) {
+        std::cout << std::endl
+                  << (tileHeight ? "Tiled (64px bands)" : "Parallel series paths") << std::endl;
+        std::cout << std::setw(8) << "threads" << std::setw(12) << "ms" << std::setw(10)
+                  << "speedup" << std::setw(12) << "identical" << std::endl;
+        
+        config.tileHeight = tileHeight;
+        config.renderThreads = 1;
+        double serialMs = timeRender(plot, repeats);
+        std::vector<uint32_t> serial = readPixels(plot);
+        
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            config.renderThreads = threads;
+            double ms = timeRender(plot, repeats);
+            bool identical = readPixels(plot) == serial;
+            std::cout << std::setw(8) << threads << std::setw(12) << std::fixed
+                      << std::setprecision(2) << ms << std::setw(10) << serialMs / ms
+                      << std::setw(12) << (identical ? "yes" : "NO") << std::endl;
+        }
+    }
+    
+    return 0;
+}
@@ -0,0 +1,451 @@
+#include "skiaplot.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Benchmark suite for the render pipeline stages: series ingest, range
+// computation, path building, markers, the per-layout draw kernels, axis
+// scales, axis text, full renders and image encoding, over point counts from
+// 1e2 to 1e8 and surfaces from thumbnail to 4K. Data comes from a fixed seed
+// and every plot renders on one thread without incremental updates, so runs
+// are comparable across machines and commits. Each case runs once to warm up,
+// then --repeats timed times.
+//
+// Usage: skiaplot_bench [--filter TEXT] [--max-points N] [--repeats N] [--json FILE]
+//
+// --max-points defaults to 1e7; pass 1e8 for the largest cases (needs
+// about 2 GB). Compare two JSON runs with bench/compare.py.
+
+namespace {
+
+struct Options {
+    std::string filter;
+    size_t maxPoints = 10000000;
+    int repeats = 5;
+    std::string jsonPath;
+};
+
+struct Result {
+    std::string name;
+    size_t points = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<double> samples;  // Milliseconds per iteration
+    
+    double min() const { return *std::min_element(samples.begin(), samples.end()); }
+    double mean() const {
+        double sum = 0.0;
+        for (double s : samples) sum += s;
+        return sum / samples.size();
+    }
+    double median() const {
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        size_t mid = sorted.size() / 2;
+        return sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2.0;
+    }
+};
+
+struct Surface {
+    const char* name;
+    int width;
+    int height;
+};
+
+constexpr Surface kSurfaces[] = {
+    {"thumb", 160, 120},
+    {"svga", 800, 600},
+    {"1080p", 1920, 1080},
+    {"4k", 3840, 2160},
+};
+
+constexpr size_t kPointCounts[] = {100, 10000, 1000000, 100000000};
+
+// Marker and undecimated line cases stop here; past it every pixel is
+// covered many times over
+constexpr size_t kMaxMarkerPoints = 1000000;
+
+class Bench {
+public:
+    explicit Bench(const Options& options) : options_(options) {}
+    
+    // Times fn, or skips it when the name does not match the filter.
+    // setup runs before every iteration and is not timed.
+    void run(const std::string& name, size_t points, int width, int height,
+             const std::function<void()>& fn, const std::function<void()>& setup = nullptr) {
+        if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) {
+            return;
+        }
+        
+        Result result{name, points, width, height, {}};
+        for (int i = 0; i <= options_.repeats; ++i) {
+            if (setup) {
+                setup();
+            }
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            double ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start).count();
+            if (i > 0) {
+                result.samples.push_back(ms);
+            }
+        }
+        report(result);
+    }
+    
+    // Records externally measured samples (e.g. encoder time from EncodeStats)
+    void record(const std::string& name, size_t points, int width, int height,
+                const std::function<double()>& sample) {
+        if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) {
+            return;
+        }
+        
+        Result result{name, points, width, height, {}};
+        sample();
+        for (int i = 0; i < options_.repeats; ++i) {
+            result.samples.push_back(sample());
+        }
+        report(result);
+    }
+    
+    bool writeJson(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            return false;
+        }
+        
+        std::time_t now = std::time(nullptr);
+        char timestamp[32];
+        std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        
+        out << "{\n  \"version\": 1,\n  \"timestamp\": \"" << timestamp << "\",\n"
+            << "  \"repeats\": " << options_.repeats << ",\n"
+            << "  \"max_points\": " << options_.maxPoints << ",\n  \"results\": [\n";
+        out << std::setprecision(6);
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const Result& r = results_[i];
+            out << "    {\"name\": \"" << r.name << "\", \"points\": " << r.points
+                << ", \"width\": " << r.width << ", \"height\": " << r.height
+                << ", \"min_ms\": " << r.min() << ", \"median_ms\": " << r.median()
+                << ", \"mean_ms\": " << r.mean() << "}" << (i + 1 < results_.size() ? "," : "")
+                << "\n";
+        }
+        out << "  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+
+private:
+    void report(const Result& result) {
+        std::cout << std::left << std::setw(44) << result.name << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(12) << result.median() << " ms"
+                  << std::setw(12) << result.min() << " ms" << std::endl;
+        results_.push_back(result);
+    }
+    
+    const Options& options_;
+    std::vector<Result> results_;
+};
+
+// Noisy sine over x in [0, 100)
+void makeData(size_t count, std::vector<double>& xs, std::vector<double>& ys) {
+    std::mt19937 gen(42);
+    std::normal_distribution<> noise(0.0, 0.1);
+    xs.resize(count);
+    ys.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        xs[i] = i * 100.0 / count;
+        ys[i] = std::sin(xs[i]) + noise(gen);
+    }
+}
+
+std::string caseName(const std::string& stage, size_t points, const Surface* surface) {
+    std::ostringstream name;
+    name << stage;
+    if (points > 0) {
+        name << "/" << points;
+    }
+    if (surface) {
+        name << "/" << surface->name;
+    }
+    return name.str();
+}
+
+SkiaPlot::PlotConfig benchConfig(const Surface& surface) {
+    SkiaPlot::PlotConfig config;
+    config.width = surface.width;
+    config.height = surface.height;
+    config.title = "Benchmark";
+    config.xLabel = "x";
+    config.yLabel = "y";
+    config.showPoints = false;
+    config.lineWidth = 1.0f;
+    config.decimate = true;
+    config.incrementalRender = false;
+    config.renderThreads = 1;
+    return config;
+}
+
+void benchSeries(Bench& bench, size_t points) {
+    std::vector<double> xs, ys;
+    makeData(points, xs, ys);
+    const Surface& svga = kSurfaces[1];
+    
+    bench.run(caseName("ingest/addPoint", points, nullptr), points, 0, 0, [&] {
+        SkiaPlot::DataSeries series;
+        for (size_t i = 0; i < points; ++i) {
+            series.addPoint(xs[i], ys[i]);
+        }
+    });
+    
+    bench.run(caseName("ingest/addPoints", points, nullptr), points, 0, 0, [&] {
+        SkiaPlot::DataSeries series;
+        series.addPoints(xs, ys);
+    });
+    
+    // setView drops the cached range, so every iteration scans
+    SkiaPlot::DataSeries view;
+    double xMin, xMax, yMin, yMax;
+    bench.run(caseName("range/getRange", points, nullptr), points, 0, 0,
+              [&] { view.getRange(xMin, xMax, yMin, yMax); },
+              [&] { view.setView(xs, ys); });
+    
+    // Lines only: the series path dominates
+    SkiaPlot::Plot lines;
+    SkiaPlot::PlotConfig config = benchConfig(svga);
+    config.showGrid = false;
+    config.title.clear();
+    config.xLabel.clear();
+    config.yLabel.clear();
+    lines.setConfig(config);
+    view.setView(xs, ys);
+    lines.addSeries(view);
+    bench.run(caseName("path/lines", points, &svga), points, svga.width, svga.height,
+              [&] { lines.render(); });
+    
+    config.decimate = false;
+    lines.setConfig(config);
+    if (points <= kMaxMarkerPoints) {
+        bench.run(caseName("path/lines_undecimated", points, &svga), points, svga.width,
+                  svga.height, [&] { lines.render(); });
+    }
+    
+    if (points <= kMaxMarkerPoints) {
+        SkiaPlot::Plot markers;
+        SkiaPlot::PlotConfig markerConfig = benchConfig(svga);
+        markerConfig.showPoints = true;
+        markerConfig.pointRadius = 2.0f;
+        markers.setConfig(markerConfig);
+        markers.addSeries(view);
+        bench.run(caseName("markers", points, &svga), points, svga.width, svga.height,
+                  [&] { markers.render(); });
+        
+        markerConfig.dedupeMarkers = true;
+        markers.setConfig(markerConfig);
+        bench.run(caseName("markers/dedupe", points, &svga), points, svga.width, svga.height,
+                  [&] { markers.render(); });
+    }
+    
+    for (const Surface& surface : kSurfaces) {
+        SkiaPlot::Plot plot;
+        plot.setConfig(benchConfig(surface));
+        plot.addSeries(view);
+        bench.run(caseName("render", points, &surface), points, surface.width, surface.height,
+                  [&] { plot.render(); });
+    }
+}
+
+void benchKernels(Bench& bench, size_t points) {
+    // Each column type and x layout runs its own instantiation of the
+    // transform, path and marker loops; a regression in one shows up here
+    std::vector<double> xs, ys;
+    makeData(points, xs, ys);
+    std::vector<float> xs32(xs.begin(), xs.end());
+    std::vector<float> ys32(ys.begin(), ys.end());
+    const Surface& svga = kSurfaces[1];
+    
+    SkiaPlot::DataSeries layouts[4];
+    layouts[0].setView(xs, ys);
+    layouts[1].setView(xs32, ys32);
+    layouts[2].setUniformView(0.0, 100.0 / points, ys);
+    layouts[3].setUniformView(0.0, 100.0 / points, ys32);
+    const char* names[] = {"f64", "f32", "uniform_f64", "uniform_f32"};
+    
+    for (int i = 0; i < 4; ++i) {
+        for (bool markers : {false, true}) {
+            SkiaPlot::Plot plot;
+            SkiaPlot::PlotConfig config = benchConfig(svga);
+            config.showGrid = false;
+            config.title.clear();
+            config.xLabel.clear();
+            config.yLabel.clear();
+            config.showPoints = markers;
+            config.pointRadius = 2.0f;
+            plot.setConfig(config);
+            plot.addSeries(layouts[i]);
+            std::string stage = std::string("kernels/") + names[i] + (markers ? "/markers" : "/lines");
+            bench.run(caseName(stage, points, &svga), points, svga.width, svga.height,
+                      [&] { plot.render(); });
+        }
+    }
+}
+
+void benchScales(Bench& bench, size_t points) {
+    // Log and symlog axes run the batched log10 kernel on both columns
+    // before the affine transform; linear is the baseline
+    std::vector<double> xs, ys;
+    makeData(points, xs, ys);
+    for (double& y : ys) {
+        y = std::exp(3.0 * y);
+    }
+    const Surface& svga = kSurfaces[1];
+    SkiaPlot::DataSeries view;
+    view.setView(xs, ys);
+    
+    const SkiaPlot::AxisScale scales[] = {SkiaPlot::AxisScale::Linear,
+                                          SkiaPlot::AxisScale::Log10,
+                                          SkiaPlot::AxisScale::SymLog};
+    const char* names[] = {"linear", "log10", "symlog"};
+    for (int i = 0; i < 3; ++i) {
+        for (bool decimate : {true, false}) {
+            SkiaPlot::Plot plot;
+            SkiaPlot::PlotConfig config = benchConfig(svga);
+            config.showGrid = false;
+            config.title.clear();
+            config.xLabel.clear();
+            config.yLabel.clear();
+            config.decimate = decimate;
+            config.xScale = scales[i];
+            config.yScale = scales[i];
+            plot.setConfig(config);
+            plot.addSeries(view);
+            std::string stage = std::string("scales/") + names[i] +
+                                (decimate ? "/lines" : "/lines_undecimated");
+            bench.run(caseName(stage, points, &svga), points, svga.width, svga.height,
+                      [&] { plot.render(); });
+        }
+    }
+}
+
+void benchText(Bench& bench) {
+    // Frame, grid, tick labels and titles without any series
+    for (const Surface& surface : kSurfaces) {
+        SkiaPlot::Plot plot;
+        plot.setConfig(benchConfig(surface));
+        SkiaPlot::DataSeries bounds;
+        bounds.addPoint(0.0, -1.0);
+        bounds.addPoint(100.0, 1.0);
+        plot.addSeries(bounds);
+        bench.run(caseName("text/axes", 0, &surface), 0, surface.width, surface.height,
+                  [&] { plot.render(); });
+    }
+}
+
+void benchEncode(Bench& bench) {
+    std::vector<double> xs, ys;
+    makeData(10000, xs, ys);
+    SkiaPlot::DataSeries series;
+    series.setView(xs, ys);
+    
+    const std::pair<const char*, SkiaPlot::ImageFormat> formats[] = {
+        {"png", SkiaPlot::ImageFormat::PNG},
+        {"jpeg", SkiaPlot::ImageFormat::JPEG},
+        {"webp", SkiaPlot::ImageFormat::WebP},
+        {"raw", SkiaPlot::ImageFormat::RawRGBA},
+    };
+    
+    for (const Surface& surface : kSurfaces) {
+        // Render once; with incremental rendering on, saving again only
+        // encodes
+        SkiaPlot::Plot plot;
+        SkiaPlot::PlotConfig config = benchConfig(surface);
+        config.incrementalRender = true;
+        plot.setConfig(config);
+        plot.addSeries(series);
+        
+        for (const auto& [label, format] : formats) {
+            double seconds = 0.0;
+            SkiaPlot::EncodeOptions options;
+            options.format = format;
+            options.onEncoded = [&seconds](const std::string&, const SkiaPlot::EncodeStats& stats) {
+                seconds = stats.seconds;
+            };
+            auto discard = [](const void*, size_t) { return true; };
+            
+            bench.record(caseName(std::string("encode/") + label, 0, &surface), 0, surface.width,
+                         surface.height, [&] {
+                seconds = 0.0;
+                plot.saveToCallback(discard, options);
+                return seconds * 1000.0;
+            });
+        }
+    }
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--max-points") {
+            options.maxPoints = static_cast<size_t>(std::strtod(value, nullptr));
+        } else if (arg == "--repeats") {
+            options.repeats = std::max(1, std::atoi(value));
+        } else if (arg == "--json") {
+            options.jsonPath = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: skiaplot_bench [--filter TEXT] [--max-points N] [--repeats N]"
+                     " [--json FILE]" << std::endl;
+        return 2;
+    }
+    
+    Bench bench(options);
+    std::cout << std::left << std::setw(44) << "case" << std::right << std::setw(15) << "median"
+              << std::setw(15) << "min" << std::endl;
+    
+    for (size_t points : kPointCounts) {
+        if (points <= options.maxPoints) {
+            benchSeries(bench, points);
+        }
+    }
+    if (kMaxMarkerPoints <= options.maxPoints) {
+        benchKernels(bench, kMaxMarkerPoints);
+        benchScales(bench, kMaxMarkerPoints);
+    }
+    benchText(bench);
+    benchEncode(bench);
+    
+    if (!options.jsonPath.empty()) {
+        if (!bench.writeJson(options.jsonPath)) {
+            std::cerr << "Failed to write " << options.jsonPath << std::endl;
+            return 1;
+        }
+        std::cout << "Results written to " << options.jsonPath << std::endl;
+    }
+    return 0;
+}
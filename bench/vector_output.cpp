@@ -0,0 +1,75 @@
+#include "skiaplot.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+// Saves the plot once and prints the time and the size of the written file
+static void timeSave(SkiaPlot::Plot& plot, const std::string& label, const std::string& filename,
+                     float tolerance) {
+    plot.getConfig().vectorTolerance = tolerance;
+    
+    size_t bytes = 0;
+    SkiaPlot::EncodeOptions options;
+    options.onEncoded = [&bytes](const std::string&, const SkiaPlot::EncodeStats& stats) {
+        bytes = stats.bytes;
+    };
+    
+    auto start = std::chrono::steady_clock::now();
+    bool ok = plot.saveToFile(filename, options);
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+    
+    std::cout << std::setw(24) << std::left << label << std::right << std::setw(12)
+              << std::fixed << std::setprecision(1) << ms << std::setw(14)
+              << (ok ? std::to_string(bytes / 1024) : std::string("failed")) << std::endl;
+}
+
+int main(int argc, char** argv) {
+    // Usage: vector_output [points]
+    int numPoints = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    
+    std::cout << "One series of " << numPoints << " points, 1200x600" << std::endl;
+    
+    std::mt19937 gen(42);
+    std::normal_distribution<> noise(0.0, 0.1);
+    
+    SkiaPlot::DataSeries series("signal");
+    for (int i = 0; i < numPoints; ++i) {
+        double x = i * 20.0 / numPoints;
+        series.addPoint(x, std::sin(x) + 0.3 * std::sin(x * 13.0) + noise(gen));
+    }
+    
+    SkiaPlot::Plot plot(1200, 600);
+    SkiaPlot::PlotConfig& config = plot.getConfig();
+    config.title = "Vector output";
+    config.showPoints = false;
+    config.lineWidth = 1.0f;
+    config.decimate = true;
+    config.incrementalRender = false;  // Time a full raster render per save
+    plot.addSeries(series);
+    
+    std::cout << std::setw(24) << std::left << "output" << std::right << std::setw(12) << "ms"
+              << std::setw(14) << "KiB" << std::endl;
+    
+    timeSave(plot, "PNG (raster)", "vector_output.png", 0.0f);
+    
+    // M4 decimation alone, then with Douglas-Peucker at the default and a
+    // coarser tolerance
+    for (const char* ext : {"svg", "pdf"}) {
+        std::string format = ext;
+        std::string filename = "vector_output." + format;
+        timeSave(plot, format + " (M4 only)", filename, 0.0f);
+        timeSave(plot, format + " (tolerance 0.25)", filename, 0.25f);
+        timeSave(plot, format + " (tolerance 1.0)", filename, 1.0f);
+    }
+    
+    // Without decimation or simplification every point becomes a vertex
+    config.decimate = false;
+    timeSave(plot, "svg (every point)", "vector_output.svg", 0.0f);
+    
+    return 0;
+}
@@ -66,6 +66,12 @@ if [ $? -eq 0 ]; then
     echo "  - ./examples/simple_plot"
     echo "  - ./examples/sine_wave"
     echo "  - ./examples/multiple_series"
+    echo "  - ./examples/large_series"
+    echo "  - ./examples/batch_render"
+    echo "  - ./examples/live_stream"
+    echo "  - ./examples/mapped_series"
+    echo "  - ./examples/density_scatter"
+    echo "  - ./examples/csv_gaps"
     echo
     echo "Run an example:"
     echo "  cd examples && ./simple_plot"
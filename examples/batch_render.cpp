@@ -0,0 +1,55 @@
+#include "skiaplot.h"
+#include <atomic>
+#include <cmath>
+#include <iostream>
+
+int main() {
+    std::cout << "Rendering a batch of small charts..." << std::endl;
+    
+    const int numCharts = 200;
+    const int numPoints = 200;
+    
+    // Render on every core; at most 64 jobs are queued at a time
+    SkiaPlot::PlotBatch batch(0, 64);
+    
+    // Thumbnails: fast deflate with a single row filter
+    std::atomic<size_t> totalBytes{0};
+    SkiaPlot::EncodeOptions encode;
+    encode.pngZlibLevel = 1;
+    encode.pngFilter = SkiaPlot::PngFilter::Sub;
+    encode.onEncoded = [&totalBytes](const std::string&, const SkiaPlot::EncodeStats& stats) {
+        totalBytes += stats.bytes;
+    };
+    
+    for (int c = 0; c < numCharts; ++c) {
+        SkiaPlot::PlotJob job;
+        job.config.width = 320;
+        job.config.height = 200;
+        job.config.marginLeft = 40;
+        job.config.marginBottom = 30;
+        job.config.showPoints = false;
+        job.config.lineWidth = 1.5f;
+        job.config.title = "Chart " + std::to_string(c);
+        job.filename = "batch_" + std::to_string(c) + ".png";
+        job.encode = encode;
+        
+        SkiaPlot::DataSeries series("signal");
+        for (int i = 0; i < numPoints; ++i) {
+            double x = i * 0.05;
+            series.addPoint(x, std::sin(x * (1 + c % 7)) * std::exp(-0.1 * x));
+        }
+        job.series.push_back(std::move(series));
+        
+        batch.submit(std::move(job));
+    }
+    
+    bool ok = batch.flush();
+    
+    const SkiaPlot::BatchStats& stats = batch.getStats();
+    std::cout << "Rendered " << stats.chartsRendered << " charts ("
+              << stats.chartsFailed << " failed) at "
+              << stats.chartsPerSecond() << " charts/sec, "
+              << totalBytes / 1024 << " KiB written" << std::endl;
+    
+    return ok ? 0 : 1;
+}
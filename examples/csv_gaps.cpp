@@ -0,0 +1,134 @@
+#include "skiaplot.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImageInfo.h"
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Pixel columns of the canvas that the (blue) series line touches
+static bool lineColumns(SkiaPlot::Plot& plot, std::vector<bool>& columns) {
+    if (!plot.render()) {
+        return false;
+    }
+    
+    const SkiaPlot::PlotConfig& config = plot.getConfig();
+    std::vector<uint8_t> pixels(static_cast<size_t>(config.width) * config.height * 4);
+    SkImageInfo info = SkImageInfo::Make(config.width, config.height, kRGBA_8888_SkColorType,
+                                         kPremul_SkAlphaType);
+    if (!plot.getCanvas()->readPixels(info, pixels.data(), config.width * 4, 0, 0)) {
+        return false;
+    }
+    
+    columns.assign(config.width, false);
+    for (int y = 0; y < config.height; ++y) {
+        for (int x = 0; x < config.width; ++x) {
+            const uint8_t* p = &pixels[(static_cast<size_t>(y) * config.width + x) * 4];
+            if (p[2] > 160 && p[0] < 96 && p[1] < 96) {
+                columns[x] = true;
+            }
+        }
+    }
+    return true;
+}
+
+// The line must be drawn on both sides of the missing rows and not across them
+static bool hasGap(const std::vector<bool>& columns) {
+    int first = -1, last = -1;
+    for (int x = 0; x < static_cast<int>(columns.size()); ++x) {
+        if (columns[x]) {
+            if (first < 0) first = x;
+            last = x;
+        }
+    }
+    for (int x = first + 1; x < last; ++x) {
+        if (!columns[x]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main() {
+    const char* path = "csv_gaps.csv";
+    const int rows = 5000;
+    
+    // Rows 2400-2599 have a blank y, and a few others an unparsable one
+    {
+        std::ofstream out(path);
+        out << "t,signal\n";
+        for (int i = 0; i < rows; ++i) {
+            out << i * 0.01 << ",";
+            if (i % 1000 == 500) {
+                out << "n/a";
+            } else if (i < 2400 || i >= 2600) {
+                out << std::sin(i * 0.004);
+            }
+            out << "\n";
+        }
+    }
+    
+    std::vector<SkiaPlot::DataSeries> columns;
+    if (!SkiaPlot::readCsvFile(path, columns) || columns.size() != 1 ||
+        columns[0].size() != rows) {
+        std::cerr << "Failed to read " << path << std::endl;
+        return 1;
+    }
+    if (!std::isnan(columns[0].y(2500)) || !std::isnan(columns[0].y(500))) {
+        std::cerr << "Missing fields were not read as NaN" << std::endl;
+        return 1;
+    }
+    
+    // A missing x must not hide the points after it from range queries
+    const char* xPath = "csv_gaps_x.csv";
+    {
+        std::ofstream out(xPath);
+        out << "t,signal\n";
+        for (int i = 0; i < 1000; ++i) {
+            if (i != 500) {
+                out << i;
+            }
+            out << "," << (i == 900 ? 100 : 1) << "\n";
+        }
+    }
+    std::vector<SkiaPlot::DataSeries> xColumns;
+    if (!SkiaPlot::readCsvFile(xPath, xColumns) || xColumns.size() != 1) {
+        std::cerr << "Failed to read " << xPath << std::endl;
+        return 1;
+    }
+    double yLow = 0.0, yHigh = 0.0;
+    xColumns[0].getYRange(0.0, 2000.0, yLow, yHigh);
+    if (xColumns[0].isSortedByX() || yLow != 1.0 || yHigh != 100.0) {
+        std::cerr << "Points after a missing x were dropped" << std::endl;
+        return 1;
+    }
+    
+    SkiaPlot::Plot plot(800, 600);
+    SkiaPlot::PlotConfig& config = plot.getConfig();
+    config.title = "CSV With Missing Values";
+    config.showPoints = false;
+    config.decimate = true;
+    plot.addSeries(columns[0]);
+    
+    // 2 px lines keep every vertex; hairlines of this many rows are decimated
+    bool ok = true;
+    for (float width : {2.0f, 1.0f}) {
+        config.lineWidth = width;
+        std::vector<bool> drawn;
+        if (!lineColumns(plot, drawn)) {
+            std::cerr << "Failed to render" << std::endl;
+            return 1;
+        }
+        bool gap = hasGap(drawn);
+        std::cout << "lineWidth " << width << ": line "
+                  << (gap ? "drawn with a gap" : "missing or without a gap") << std::endl;
+        ok = ok && gap;
+    }
+    
+    if (plot.saveToFile("csv_gaps.png")) {
+        std::cout << "Plot saved to csv_gaps.png" << std::endl;
+    }
+    
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#include "skiaplot.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+// Renders the plot once and returns the time in milliseconds
+static double timeRender(SkiaPlot::Plot& plot) {
+    auto start = std::chrono::steady_clock::now();
+    plot.render();
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    std::cout << "Creating a density scatter plot..." << std::endl;
+    
+    // Two overlapping clusters, far more points than the plot has pixels
+    const int numPoints = 2000000;
+    std::mt19937 gen(3);
+    std::normal_distribution<> wide(0.0, 1.0);
+    std::normal_distribution<> narrow(1.5, 0.3);
+    
+    SkiaPlot::DataSeries series("samples");
+    for (int i = 0; i < numPoints; ++i) {
+        if (i % 4 == 0) {
+            series.addPoint(narrow(gen), narrow(gen));
+        } else {
+            double x = wide(gen);
+            series.addPoint(x, 0.5 * x + wide(gen) * 0.8);
+        }
+    }
+    
+    SkiaPlot::Plot plot(800, 600);
+    SkiaPlot::PlotConfig& config = plot.getConfig();
+    config.title = "2M Samples";
+    config.pointRadius = 1.0f;
+    config.renderThreads = 0;
+    config.incrementalRender = false;
+    plot.addSeries(series);
+    
+    // Every point as a marker (plus the connecting line), then binned into a per-pixel histogram
+    config.showPoints = true;
+    double markerMs = timeRender(plot);
+    
+    config.density = true;
+    double densityMs = timeRender(plot);
+    
+    std::cout << "Markers: " << markerMs << " ms" << std::endl;
+    std::cout << "Density: " << densityMs << " ms" << std::endl;
+    
+    if (plot.saveToFile("density_scatter.png")) {
+        std::cout << "Plot saved to density_scatter.png" << std::endl;
+    }
+    
+    config.colormap = SkiaPlot::Colormap::Magma;
+    config.densityLogScale = false;
+    if (plot.saveToFile("density_scatter_linear.png")) {
+        std::cout << "Plot saved to density_scatter_linear.png" << std::endl;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "skiaplot.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+int main() {
+    std::cout << "Rendering a 6x8 grid of panels into one image..." << std::endl;
+    
+    SkiaPlot::FigureConfig layout;
+    layout.rows = 6;
+    layout.columns = 8;
+    layout.panelWidth = 240;
+    layout.panelHeight = 160;
+    layout.spacing = 8;
+    SkiaPlot::Figure figure(layout);
+    
+    for (int row = 0; row < layout.rows; ++row) {
+        for (int column = 0; column < layout.columns; ++column) {
+            int index = row * layout.columns + column;
+            SkiaPlot::Plot& panel = figure.panel(row, column);
+            SkiaPlot::PlotConfig& config = panel.getConfig();
+            config.title = "Sensor " + std::to_string(index);
+            config.marginLeft = 40;
+            config.marginBottom = 30;
+            config.showPoints = false;
+            config.lineWidth = 1.5f;
+            
+            SkiaPlot::DataSeries series("signal");
+            for (int i = 0; i < 500; ++i) {
+                double x = i * 0.02;
+                series.addPoint(x, std::sin(x * (1 + index % 5)) * std::exp(-0.1 * x));
+            }
+            panel.addSeries(std::move(series));
+        }
+    }
+    
+    // One surface, panels rendered in parallel, one PNG encode
+    auto start = std::chrono::steady_clock::now();
+    bool ok = figure.saveToFile("figure_grid.png");
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+    
+    if (ok) {
+        std::cout << "Saved figure_grid.png (" << figure.getWidth() << "x" << figure.getHeight()
+                  << ", " << layout.rows * layout.columns << " panels) in " << ms << " ms"
+                  << std::endl;
+    } else {
+        std::cerr << "Failed to save figure_grid.png" << std::endl;
+    }
+    
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include "skiaplot.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImageInfo.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+// Renders the plot and copies its pixels out of the canvas
+static bool renderPixels(SkiaPlot::Plot& plot, std::vector<uint32_t>& pixels, double& millis) {
+    auto start = std::chrono::steady_clock::now();
+    if (!plot.render()) {
+        return false;
+    }
+    millis = std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - start).count();
+    
+    const SkiaPlot::PlotConfig& config = plot.getConfig();
+    pixels.resize(static_cast<size_t>(config.width) * config.height);
+    SkImageInfo info = SkImageInfo::MakeN32Premul(config.width, config.height);
+    return plot.getCanvas()->readPixels(info, pixels.data(), config.width * 4, 0, 0);
+}
+
+int main() {
+    std::cout << "Creating a large series plot..." << std::endl;
+    
+    // Noisy signal with far more points than pixel columns
+    const int numPoints = 2000000;
+    std::mt19937 gen(42);
+    std::normal_distribution<> noise(0.0, 0.2);
+    
+    SkiaPlot::DataSeries series("signal");
+    for (int i = 0; i < numPoints; ++i) {
+        double x = i * 10.0 / numPoints;
+        series.addPoint(x, std::sin(x) + noise(gen));
+    }
+    
+    SkiaPlot::Plot plot(800, 600);
+    SkiaPlot::PlotConfig& config = plot.getConfig();
+    config.title = "2M Points";
+    config.showPoints = false;
+    config.lineWidth = 1.0f;
+    plot.addSeries(series);
+    
+    // Render once with M4 decimation and once with the full path. The
+    // decimated line approximates the full one: overlapping antialiased
+    // segments in a column are no longer blended over each other
+    std::vector<uint32_t> decimated, full;
+    double decimatedMs = 0.0, fullMs = 0.0;
+    plot.setStatsEnabled(true);
+    
+    config.decimate = true;
+    if (!renderPixels(plot, decimated, decimatedMs)) {
+        std::cerr << "Failed to render decimated plot" << std::endl;
+        return 1;
+    }
+    size_t decimatedVerbs = plot.getRenderStats().pathVerbs;
+    
+    config.decimate = false;
+    if (!renderPixels(plot, full, fullMs)) {
+        std::cerr << "Failed to render full plot" << std::endl;
+        return 1;
+    }
+    size_t fullVerbs = plot.getRenderStats().pathVerbs;
+    
+    size_t differing = 0;
+    for (size_t i = 0; i < full.size(); ++i) {
+        if (full[i] != decimated[i]) {
+            ++differing;
+        }
+    }
+    
+    std::cout << "Decimated render: " << decimatedMs << " ms, " << decimatedVerbs << " verbs"
+              << std::endl;
+    std::cout << "Full render:      " << fullMs << " ms, " << fullVerbs << " verbs"
+              << std::endl;
+    std::cout << "Differing pixels: " << differing << std::endl;
+    
+    // At most four points per pixel column, whatever the series length
+    size_t maxDecimatedVerbs = 5 * static_cast<size_t>(config.width);
+    bool bounded = decimatedVerbs > 0 && decimatedVerbs <= maxDecimatedVerbs &&
+                   fullVerbs >= static_cast<size_t>(numPoints);
+    if (!bounded) {
+        std::cerr << "Decimated path is not bounded by the plot width" << std::endl;
+    }
+    
+    // 2 px antialiased lines with markers keep every vertex, so the
+    // decimate flag must not change their pixels
+    config.decimate = true;
+    SkiaPlot::PlotConfig hairline = config;
+    SkiaPlot::PlotConfig defaults;
+    defaults.title = config.title;
+    defaults.decimate = true;
+    std::vector<uint32_t> defaultOn, defaultOff;
+    double defaultOnMs = 0.0, defaultOffMs = 0.0;
+    plot.setConfig(defaults);
+    if (!renderPixels(plot, defaultOn, defaultOnMs)) {
+        std::cerr << "Failed to render plot with 2 px lines" << std::endl;
+        return 1;
+    }
+    defaults.decimate = false;
+    plot.setConfig(defaults);
+    if (!renderPixels(plot, defaultOff, defaultOffMs)) {
+        std::cerr << "Failed to render plot with 2 px lines" << std::endl;
+        return 1;
+    }
+    
+    size_t defaultDiffering = 0;
+    for (size_t i = 0; i < defaultOn.size(); ++i) {
+        if (defaultOn[i] != defaultOff[i]) {
+            ++defaultDiffering;
+        }
+    }
+    std::cout << "Differing pixels at 2 px lines: " << defaultDiffering << std::endl;
+    
+    plot.setConfig(hairline);
+    if (plot.saveToFile("large_series.png")) {
+        std::cout << "Plot saved to large_series.png" << std::endl;
+    }
+    
+    return bounded && defaultDiffering == 0 ? 0 : 1;
+}
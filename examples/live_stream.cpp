@@ -0,0 +1,64 @@
+#include "skiaplot.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+
+// Feeds a simulated 500 Hz sensor into a live plot frame by frame and
+// returns the average render time per frame
+static double streamFrames(bool incremental, int numFrames) {
+    const double sampleRate = 500.0;
+    const int samplesPerFrame = 10;
+    
+    std::mt19937 gen(7);
+    std::normal_distribution<> noise(0.0, 0.05);
+    
+    // Keep the last 20 seconds on a fixed axis
+    auto live = std::make_shared<SkiaPlot::StreamingSeries>("sensor", 0, 20.0);
+    
+    SkiaPlot::Plot plot(800, 400);
+    SkiaPlot::PlotConfig& config = plot.getConfig();
+    config.title = "Live Sensor";
+    config.showPoints = false;
+    config.lineWidth = 1.0f;
+    config.xMin = 0.0;
+    config.xMax = 20.0;
+    config.yMin = -1.5;
+    config.yMax = 1.5;
+    config.incrementalRender = incremental;
+    plot.addSeries(live);
+    
+    double totalMs = 0.0;
+    long sample = 0;
+    for (int frame = 0; frame < numFrames; ++frame) {
+        for (int i = 0; i < samplesPerFrame; ++i, ++sample) {
+            double t = sample / sampleRate;
+            live->append(t, std::sin(t * 2.0) + noise(gen));
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        plot.render();
+        totalMs += std::chrono::duration<double, std::milli>(
+                       std::chrono::steady_clock::now() - start).count();
+    }
+    
+    if (incremental && plot.saveToFile("live_stream.png")) {
+        std::cout << "Last frame saved to live_stream.png" << std::endl;
+    }
+    
+    return totalMs / numFrames;
+}
+
+int main() {
+    std::cout << "Streaming into a live plot..." << std::endl;
+    
+    const int numFrames = 900;
+    double fullMs = streamFrames(false, numFrames);
+    double incrementalMs = streamFrames(true, numFrames);
+    
+    std::cout << "Full redraw per frame:  " << fullMs << " ms" << std::endl;
+    std::cout << "Incremental per frame:  " << incrementalMs << " ms" << std::endl;
+    
+    return 0;
+}
@@ -4,16 +4,43 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <optional>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
 #include <cmath>
+#include <chrono>
+#include <mutex>
 
 // Forward declarations for Skia types
 class SkCanvas;
 class SkSurface;
 class SkPaint;
 class SkPath;
+class SkWStream;
+class SkImage;
+class SkPicture;
+struct SkRect;
 
 namespace SkiaPlot {
 
+class ThreadPool;
+class SurfacePool;
+class MarkerCache;
+class TextCache;
+class MinMaxPyramid;
+struct MarkerSprite;
+struct AxisTick;
+struct RenderResources;
+struct RenderArena;
+struct RasterState;
+struct BatchSlot;
+struct PipelineItem;
+struct PipelineState;
+struct PlotJob;
+struct StatsRecorder;
+
 /**
  * @brief Represents a data point with x and y coordinates
  */
@@ -25,27 +52,376 @@ struct Point {
     Point(double x_, double y_) : x(x_), y(y_) {}
 };
 
+/**
+ * @brief Non-owning view of a contiguous array (stand-in for C++20 std::span)
+ */
+template <typename T>
+class Span {
+public:
+    Span() = default;
+    Span(const T* data, size_t size) : data_(data), size_(size) {}
+    Span(const std::vector<T>& values) : data_(values.data()), size_(values.size()) {}
+    
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Storage type of a series' coordinate columns
+ */
+enum class ValueType {
+    Float64,
+    Float32
+};
+
+/**
+ * @brief Read-only view of one coordinate column of a DataSeries
+ *
+ * The x column of a uniform-x series has no data; value i is
+ * start + i * step.
+ */
+struct ColumnView {
+    const void* data = nullptr;
+    ValueType type = ValueType::Float64;
+    size_t size = 0;
+    bool uniform = false;
+    double start = 0.0;
+    double step = 0.0;
+    
+    const double* asFloat64() const { return static_cast<const double*>(data); }
+    const float* asFloat32() const { return static_cast<const float*>(data); }
+    
+    double operator[](size_t i) const {
+        if (uniform) {
+            return start + static_cast<double>(i) * step;
+        }
+        return type == ValueType::Float64 ? asFloat64()[i] : asFloat32()[i];
+    }
+};
+
 /**
  * @brief Represents a series of data points to be plotted
+ *
+ * Coordinates are stored column-wise (separate contiguous x and y arrays) as
+ * float64 or float32. A series either owns its columns or, after setView(),
+ * references caller-owned buffers without copying them. Copying a view
+ * series copies only the view, so the buffers must outlive every copy,
+ * including the ones held by a Plot.
+ *
+ * Uniformly sampled signals can be stored as uniform-x series: only y is
+ * kept and x(i) = x0 + i * dx, which halves memory and makes x ranges and
+ * x lookups O(1).
  */
 class DataSeries {
 public:
-    DataSeries(const std::string& name = "Data");
+    DataSeries(const std::string& name = "Data", ValueType type = ValueType::Float64);
+    virtual ~DataSeries() = default;
     
+    // Copying ingestion (a view series is first copied into owned storage)
     void addPoint(double x, double y);
     void addPoints(const std::vector<Point>& points);
+    void addPoints(Span<double> x, Span<double> y);
     void setPoints(const std::vector<Point>& points);
     
-    const std::vector<Point>& getPoints() const { return points_; }
+    // Take ownership of existing columns without copying them
+    void setData(std::vector<double> x, std::vector<double> y);
+    void setData(std::vector<float> x, std::vector<float> y);
+    
+    // Reference caller-owned columns without copying them. The optional
+    // owner is kept alive while the series (or a copy) uses the columns.
+    void setView(Span<double> x, Span<double> y, std::shared_ptr<const void> owner = nullptr);
+    void setView(Span<float> x, Span<float> y, std::shared_ptr<const void> owner = nullptr);
+    
+    // Uniform-x series, owning or referencing the y column
+    void setUniformData(double x0, double dx, std::vector<double> y);
+    void setUniformData(double x0, double dx, std::vector<float> y);
+    void setUniformView(double x0, double dx, Span<double> y,
+                        std::shared_ptr<const void> owner = nullptr);
+    void setUniformView(double x0, double dx, Span<float> y,
+                        std::shared_ptr<const void> owner = nullptr);
+    
+    // Append y values at the next x positions of a uniform-x series; returns
+    // false (and adds nothing) for a series with explicit x. Adding points
+    // with addPoint()/addPoints() stores x explicitly from then on.
+    bool addValues(Span<double> y);
+    
+    void clear();
+    
+    // Storage control for owned columns, in points. reserve() copies a view
+    // into owned storage first; clear() keeps the capacity for reuse, and
+    // shrinkToFit() releases what the current points do not need.
+    void reserve(size_t count);
+    size_t capacity() const;
+    void shrinkToFit();
+    
+    // Drop the oldest points (amortized O(1) per point)
+    void removeFront(size_t count);
+    
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+    double x(size_t i) const { return xColumn()[i]; }
+    double y(size_t i) const { return yColumn()[i]; }
+    ColumnView xColumn() const;
+    ColumnView yColumn() const;
+    ValueType getValueType() const { return type_; }
+    bool isView() const { return viewY_ != nullptr; }
+    bool isUniformX() const { return uniformX_; }
+    
+    // Compatibility path: materializes interleaved points on first use
+    const std::vector<Point>& getPoints() const;
+    
     const std::string& getName() const { return name_; }
     void setName(const std::string& name) { name_ = name; }
     
-    // Get data range
-    void getRange(double& xMin, double& xMax, double& yMin, double& yMax) const;
+    // True when x values never decrease and none is NaN (required for
+    // per-column decimation and binary search by x). Checked on first use,
+    // so setting a view does not touch its data.
+    bool isSortedByX() const;
+    
+    // Change tracking: the revision changes on every edit except appends
+    // and removeFront(); getRemovedCount() counts points dropped from the
+    // front since then, so index i is point number getRemovedCount() + i.
+    uint64_t getRevision() const { return revision_; }
+    uint64_t getRemovedCount() const { return removed_; }
+    
+    // Get data range (cached, and extended incrementally on append)
+    virtual void getRange(double& xMin, double& xMax, double& yMin, double& yMax) const;
+    
+    // Smallest positive x and y (NaN if there are none), where log axes
+    // start; cached like the range, and O(1) for the x of uniform series
+    void getMinPositive(double& xMin, double& yMin) const;
+    
+    // Range of y over the points with xFrom <= x <= xTo (NaN if there are
+    // none); O(log N) for an x-sorted series with a pyramid
+    void getYRange(double xFrom, double xTo, double& yMin, double& yMax) const;
+    
+    // Indices of the smallest and largest y in [begin, end), skipping NaN;
+    // false if there is none. If missing is set, it receives the number of
+    // non-finite y in the range, which series lines draw as gaps.
+    bool findYExtremes(size_t begin, size_t end, size_t& minIndex, size_t& maxIndex,
+                       size_t* missing = nullptr) const;
     
+    // Min/max pyramid (level-of-detail index of y extremes). With it, y
+    // ranges over any window cost O(log N) instead of a scan, and decimated
+    // renders touch O(pixels * log N) points, plus every point of columns
+    // with missing y, so lines break at them as without a pyramid. It
+    // follows appends and front removals incrementally and is rebuilt on
+    // first use after other edits; copies of the series share it until
+    // either side changes. A saved pyramid records a hash of all x and y
+    // values, and loads only into the same data (without front removals);
+    // checking the hash reads the series once.
+    void buildPyramid(size_t blockSize = 64);
+    void dropPyramid() { pyramid_.reset(); }
+    bool hasPyramid() const { return pyramid_ != nullptr; }
+    bool savePyramid(const std::string& path) const;
+    bool loadPyramid(const std::string& path);
+
 private:
+    void clearStorage();
+    void compact();
+    void detachView();
+    void storeX();
+    const MinMaxPyramid& pyramid() const;
+    void pointsChanged(size_t from);
+    
     std::string name_;
-    std::vector<Point> points_;
+    ValueType type_;
+    
+    // Owned columns; only the pair matching type_ is used. Points before
+    // head_ have been removed and are compacted away lazily.
+    std::vector<double> x64_, y64_;
+    std::vector<float> x32_, y32_;
+    size_t head_ = 0;
+    
+    // Uniform x grid; x0_ is the x of point number 0 (see getRemovedCount)
+    bool uniformX_ = false;
+    double x0_ = 0.0;
+    double dx_ = 1.0;
+    
+    // Borrowed columns, set by setView() (only y for uniform-x series)
+    const void* viewX_ = nullptr;
+    const void* viewY_ = nullptr;
+    size_t viewSize_ = 0;
+    std::shared_ptr<const void> viewOwner_;
+    
+    mutable std::vector<Point> pointsCache_;
+    mutable bool pointsCacheValid_ = false;
+    mutable double range_[4] = {0.0, 0.0, 0.0, 0.0};
+    mutable bool rangeValid_ = false;
+    mutable double minPositive_[2] = {0.0, 0.0};
+    mutable bool minPositiveValid_ = false;
+    mutable bool sortedByX_ = true;
+    mutable size_t sortedCheckedTo_ = 0;
+    mutable std::shared_ptr<MinMaxPyramid> pyramid_;
+    uint64_t revision_ = 0;
+    uint64_t removed_ = 0;
+};
+
+/**
+ * @brief Live series with ring-buffer semantics for monitoring panels.
+ *
+ * append() adds points and then evicts the oldest ones beyond the capacity
+ * or older than the time window (x of the newest point minus timeWindow).
+ * The y range of the live window is tracked with monotonic queues, so
+ * getRange() costs O(1) amortized per appended point instead of a rescan.
+ * Share it with a Plot through Plot::addSeries(std::shared_ptr<...>).
+ */
+class StreamingSeries : public DataSeries {
+public:
+    explicit StreamingSeries(const std::string& name = "Stream", size_t capacity = 0,
+                             double timeWindow = 0.0, ValueType type = ValueType::Float64);
+    
+    // Eviction limits; 0 disables a limit
+    void setCapacity(size_t capacity);
+    void setTimeWindow(double timeWindow);
+    size_t getCapacity() const { return capacity_; }
+    double getTimeWindow() const { return timeWindow_; }
+    
+    void append(double x, double y);
+    void append(Span<double> x, Span<double> y);
+    
+    void getRange(double& xMin, double& xMax, double& yMin, double& yMax) const override;
+
+private:
+    void evict();
+    
+    size_t capacity_;
+    double timeWindow_;
+    
+    // Point numbers (see getRemovedCount) of the running y minimum/maximum
+    // candidates, oldest first
+    mutable std::deque<uint64_t> minQueue_, maxQueue_;
+    mutable uint64_t trackedEnd_ = 0;
+    mutable uint64_t trackedRevision_ = 0;
+};
+
+/**
+ * @brief How data values are spaced along an axis
+ */
+enum class AxisScale {
+    Linear,
+    Log10,   // Non-positive values are clipped below the bottom of the axis
+    SymLog   // sign(v) * log10(1 + |v| / threshold): linear near zero, log
+             // beyond the threshold, defined for any sign
+};
+
+/**
+ * @brief Mapping of one data axis onto canvas coordinates: the axis scale
+ * takes data values to scaled values, then an affine map takes those to
+ * canvas units
+ */
+struct AxisTransform {
+    double origin = 0.0;  // Scaled value that maps to offset
+    double scale = 1.0;   // Canvas units per scaled unit (negative for y)
+    double offset = 0.0;  // Canvas coordinate of origin
+    AxisScale mapping = AxisScale::Linear;
+    double threshold = 1.0;  // SymLog only: half-width of the linear region
+    
+    bool isLinear() const { return mapping == AxisScale::Linear; }
+    double forward(double value) const {
+        return mapping == AxisScale::Linear ? value : forwardNonlinear(value);
+    }
+    double inverse(double scaled) const {
+        return mapping == AxisScale::Linear ? scaled : inverseNonlinear(scaled);
+    }
+    double apply(double value) const { return offset + (forward(value) - origin) * scale; }
+    double invert(double canvas) const { return inverse(origin + (canvas - offset) / scale); }
+
+private:
+    double forwardNonlinear(double value) const;
+    double inverseNonlinear(double scaled) const;
+};
+
+/**
+ * @brief Layout of a flat binary series file.
+ *
+ * Values are little-endian float64 or float32. The x and y columns each
+ * start at a byte offset and advance by stride bytes per point, so packed
+ * columns, interleaved x/y pairs and records with extra fields can all be
+ * described. With uniformX there is no x column and x = x0 + i * dx.
+ */
+struct SeriesFileInfo {
+    ValueType type = ValueType::Float64;
+    uint64_t count = 0;     // Points; 0 = as many as fit (packed columns only)
+    uint64_t stride = 0;    // Bytes from one value of a column to the next; 0 = packed
+    uint64_t xOffset = 0;   // Byte offset of the first x value
+    uint64_t yOffset = 0;   // Byte offset of the first y value; with an x column,
+                            // 0 = right after a packed x column
+    bool uniformX = false;
+    double x0 = 0.0;
+    double dx = 1.0;
+};
+
+/**
+ * @brief Memory-mapped series files.
+ *
+ * Files written by writeSeriesFile() start with a 64-byte self-describing
+ * header (magic "SKPS", see USAGE.md); headerless files are opened with an
+ * explicit SeriesFileInfo. Packed columns become a zero-copy view over the
+ * mapping (a uniform-x series for uniform-x files), so opening is O(1) and
+ * only pages that rendering reads are loaded. Strided or misaligned files
+ * are copied into the series.
+ */
+bool openSeriesFile(const std::string& path, DataSeries& series);
+bool openSeriesFile(const std::string& path, const SeriesFileInfo& info, DataSeries& series);
+bool readSeriesFileInfo(const std::string& path, SeriesFileInfo& info);
+bool writeSeriesFile(const std::string& path, const DataSeries& series);
+
+/**
+ * @brief Column selection and parsing options for CSV/TSV files
+ */
+struct CsvOptions {
+    char delimiter = 0;          // 0 = tab if the first line has one, else comma
+    bool header = true;          // First line holds the column (series) names
+    int xColumn = 0;             // -1 = no x column: x is the row number
+    std::vector<int> yColumns;   // One series per column; empty = all but x
+    ValueType type = ValueType::Float64;
+    int threads = 0;             // Parser threads (0 = one per hardware thread)
+};
+
+/**
+ * @brief Delimited text import.
+ *
+ * The file is memory-mapped and split into chunks at line breaks. Rows
+ * are counted per chunk in parallel, the columns are allocated once, and
+ * every chunk then parses its rows straight into its slice of them with
+ * std::from_chars. Blank lines and lines starting with '#' are skipped;
+ * empty, missing or malformed fields become NaN, which renders as a gap.
+ * series is replaced with one series per y column. With several y
+ * columns the series are views that share one x column, so editing one
+ * (e.g. addPoint) first copies its columns.
+ */
+bool readCsvFile(const std::string& path, std::vector<DataSeries>& series,
+                 const CsvOptions& options = CsvOptions());
+bool parseCsv(const char* text, size_t size, std::vector<DataSeries>& series,
+              const CsvOptions& options = CsvOptions());
+
+/**
+ * @brief Point marker shapes, all fitting a circle of PlotConfig::pointRadius
+ */
+enum class MarkerShape {
+    Circle,
+    Square,
+    Diamond,
+    Triangle,
+    Cross
+};
+
+/**
+ * @brief Color scales for density rendering, from low to high counts
+ */
+enum class Colormap {
+    Viridis,
+    Magma,
+    Grayscale
 };
 
 /**
@@ -73,6 +449,64 @@ struct PlotConfig {
     bool showGrid = true;
     bool showPoints = true;
     float pointRadius = 4.0f;
+    MarkerShape markerShape = MarkerShape::Circle;
+    
+    // Opt-in for dense scatter plots: stamp each quarter-pixel marker
+    // position of an opaque series once instead of once per point. Faster,
+    // but stacked markers are no longer painted over each other, so their
+    // antialiased edges come out lighter than with every point drawn.
+    bool dedupeMarkers = false;
+    
+    // Opt-in for large series: reduce each line to the first, last, min and
+    // max point of every pixel column (M4) before building the path. Only
+    // applies to x-sorted series with more than a few points per column,
+    // drawn with lineWidth <= 1 (hairlines); wider strokes keep every vertex.
+    // An approximation: each column keeps the extent of the full line, but
+    // antialiased segments that overlap in a column are no longer blended
+    // over each other, so dense columns come out lighter than undecimated.
+    bool decimate = false;
+    
+    // Density mode for heavily overplotted data: instead of lines and
+    // markers, bin the points of all series into a per-pixel 2D histogram
+    // and draw it through a colormap (log scale by default)
+    bool density = false;
+    Colormap colormap = Colormap::Viridis;
+    bool densityLogScale = true;
+    
+    // SVG/PDF output: simplify series lines (Douglas-Peucker) so no point
+    // moves more than this many pixels; 0 keeps every point
+    float vectorTolerance = 0.25f;
+    
+    // Fixed axis limits; unset limits follow the data with 5% padding
+    // (measured on the axis scale)
+    std::optional<double> xMin, xMax, yMin, yMax;
+    
+    // Axis scales. Log10 axes range over the positive data only; SymLog
+    // axes are linear within symlogThreshold of zero.
+    AxisScale xScale = AxisScale::Linear;
+    AxisScale yScale = AxisScale::Linear;
+    double symlogThreshold = 1.0;
+    
+    // Opt-in for live data: when only streaming appends/evictions changed
+    // since the last render and the axis range is unchanged, repaint just
+    // the affected pixel columns. A render with no changes at all then
+    // leaves the surface as it is. Off, every render draws a full frame.
+    bool incrementalRender = false;
+    
+    // Once two renders in a row share the config and axis range, keep the
+    // background, grid and axes as a raster layer and the labels as a
+    // picture, and reuse them until either changes. Costs one extra
+    // width x height image.
+    bool cacheStaticLayer = true;
+    
+    // Parallel rendering: worker threads for series path construction and
+    // tile rasterization (1 = serial, 0 = one per hardware thread). The
+    // thread count never changes the output.
+    int renderThreads = 1;
+    
+    // Rasterize in horizontal bands of this many pixels (0 = one pass).
+    // Bands are drawn independently, so they can run on separate threads.
+    int tileHeight = 0;
     
     // Labels
     std::string title;
@@ -82,6 +516,134 @@ struct PlotConfig {
     PlotConfig() = default;
 };
 
+bool operator==(const PlotConfig& a, const PlotConfig& b);
+inline bool operator!=(const PlotConfig& a, const PlotConfig& b) { return !(a == b); }
+
+/**
+ * @brief Output image formats
+ */
+enum class ImageFormat {
+    Auto,     // From the file extension (.png, .jpg/.jpeg, .webp, .rgba/.raw,
+              // .svg, .pdf); PNG otherwise
+    PNG,
+    JPEG,
+    WebP,
+    RawRGBA,  // Unpremultiplied RGBA bytes, row by row, no header
+    SVG,      // Vector output, see PlotConfig::vectorTolerance
+    PDF
+};
+
+/**
+ * @brief PNG row filters; fewer filters encode faster, All compresses best
+ */
+enum class PngFilter {
+    All,
+    None,
+    Sub,
+    Up,
+    Average,
+    Paeth
+};
+
+/**
+ * @brief Time and size of one encoded image
+ */
+struct EncodeStats {
+    ImageFormat format = ImageFormat::PNG;  // Format actually written
+    size_t bytes = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Per-stage timings and counters of the last render or save.
+ *
+ * Collected only while enabled with Plot::setStatsEnabled() or a trace
+ * recorder is attached. Stages drawn once per tile are summed over the
+ * tiles, so with tileHeight set they can add up to more than renderSeconds.
+ */
+struct RenderStats {
+    // Seconds per stage
+    double setupCanvas = 0.0;
+    double computeDataRange = 0.0;
+    double buildPaths = 0.0;  // Series geometry, or binning in density mode
+    double drawBackground = 0.0;
+    double drawGrid = 0.0;
+    double drawAxes = 0.0;
+    double drawSeries = 0.0;  // Series lines
+    double drawMarkers = 0.0;  // Point markers
+    double drawLabels = 0.0;
+    double encode = 0.0;  // For SVG and PDF, the whole document write
+    double renderSeconds = 0.0;  // Whole render()
+    
+    // Counters
+    size_t pointsIn = 0;  // Points in all series
+    size_t pathVerbs = 0;  // Verbs in the series paths after decimation
+    size_t markersDrawn = 0;  // Markers drawn after culling, summed over tiles
+    size_t bytesEncoded = 0;
+};
+
+/**
+ * @brief Collects render stages as Chrome trace events.
+ *
+ * Attach one to any number of plots with Plot::setTraceRecorder(); it is
+ * thread-safe. writeJson() output loads in chrome://tracing or Perfetto.
+ */
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Event {
+        const char* name;  // Must outlive the recorder, e.g. a literal
+        double start;  // Microseconds since the recorder was created
+        double duration;  // Microseconds
+        uint32_t thread;  // Small index in order of first appearance
+    };
+    
+    TraceRecorder();
+    
+    void record(const char* name, Clock::time_point start, Clock::time_point end);
+    void clear();
+    std::vector<Event> events() const;
+    
+    // Chrome trace-event JSON ("X" complete events)
+    std::string toJson() const;
+    bool writeJson(const std::string& filename) const;
+
+private:
+    Clock::time_point epoch_;
+    mutable std::mutex mutex_;
+    std::vector<Event> events_;
+    std::vector<std::pair<uint64_t, uint32_t>> threads_;
+};
+
+/**
+ * @brief Image encoding settings for saveToFile() and PlotBatch jobs.
+ *
+ * The defaults write PNG at zlib level 6 with all row filters.
+ * For thumbnails, pngZlibLevel = 1 with PngFilter::Sub is several times
+ * faster at a small size cost.
+ */
+struct EncodeOptions {
+    ImageFormat format = ImageFormat::Auto;
+    
+    // PNG: deflate level (0 = store, 9 = smallest) and row filters
+    int pngZlibLevel = 6;
+    PngFilter pngFilter = PngFilter::All;
+    
+    // WebP: lossless, or lossy with the quality below
+    bool webpLossless = true;
+    
+    // JPEG and lossy WebP quality (0-100)
+    int quality = 90;
+    
+    // Called after each successful write with the file name and stats. In a
+    // PlotBatch it runs on the render threads, so it must be thread-safe.
+    std::function<void(const std::string&, const EncodeStats&)> onEncoded;
+};
+
+// Receives encoded bytes as they are produced; return false to abort
+using WriteCallback = std::function<bool(const void* data, size_t size)>;
+
 /**
  * @brief Main plotting class that renders data using Skia
  */
@@ -96,35 +658,302 @@ public:
     
     // Data management
     void addSeries(const DataSeries& series);
+    void addSeries(DataSeries&& series);  // Moves the columns, no copy
+    
+    // Add a live series: later appends/evictions show up in the next render()
+    void addSeries(std::shared_ptr<DataSeries> series);
     void clearSeries();
     
     // Rendering
     bool render();
     bool saveToFile(const std::string& filename);
+    bool saveToFile(const std::string& filename, const EncodeOptions& options);
+    
+    // Render into caller-owned memory: width x height pixels in the native
+    // 32-bit premultiplied format (kN32), rows rowBytes apart. The buffer is
+    // not retained after the call.
+    bool renderTo(void* pixels, size_t rowBytes);
+    
+    // Render and encode straight into a stream or callback, without
+    // buffering the encoded image (format Auto means PNG here)
+    bool saveToStream(SkWStream& stream, const EncodeOptions& options = EncodeOptions());
+    bool saveToCallback(const WriteCallback& write,
+                        const EncodeOptions& options = EncodeOptions());
     
     // Get the canvas for custom drawing
     SkCanvas* getCanvas();
     
+    // Instrumentation; off by default and nearly free while off. Stats
+    // are reset by every render() and vector save.
+    void setStatsEnabled(bool enabled);
+    void setTraceRecorder(std::shared_ptr<TraceRecorder> recorder);
+    const RenderStats& getRenderStats() const;
+
 private:
     void setupCanvas();
     void drawBackground(SkCanvas* canvas);
     void drawGrid(SkCanvas* canvas);
     void drawAxes(SkCanvas* canvas);
-    void drawSeries(SkCanvas* canvas, const DataSeries& series, uint32_t color);
+    void buildSeriesPath(const DataSeries& series, SkPath& path, size_t begin = 0,
+                         size_t end = SIZE_MAX) const;
+    
+    // Viewport culling: the axes' rectangle on the canvas, and the index
+    // range of a series that can draw into it
+    SkRect plotArea() const;
+    void visibleRange(const DataSeries& series, size_t& begin, size_t& end) const;
+    void drawSeries(SkCanvas* canvas, const DataSeries& series, const SkPath& path,
+                    uint32_t color, size_t begin = 0, size_t end = SIZE_MAX);
+    void drawMarkers(SkCanvas* canvas, const DataSeries& series, const MarkerSprite& sprite,
+                     uint32_t color, size_t begin, size_t end);
+    void prepareMarkers();
+    void buildDensityImage();
     void drawLabels(SkCanvas* canvas);
+    void prepareText();
+    // Ticks of one axis over [min, max], placed from canvas coordinate start
+    // over length units (negative for y)
+    void layoutTicks(const AxisTransform& axis, double min, double max, int start, int length,
+                     std::vector<AxisTick>& ticks);
+    void drawFrame(SkCanvas* canvas, const std::vector<SkPath>& paths);
+    
+    // Cached decoration: everything below the series, and the labels above
+    void prepareStaticLayer();
+    void drawStaticLayer(SkCanvas* canvas);
+    void drawLabelLayer(SkCanvas* canvas);
+    ThreadPool* threadPool();
+    RenderArena& arena();
+    
+    // Incremental rendering of streaming updates
+    bool findDirtyColumns(int& left, int& right) const;
+    void renderColumns(SkCanvas* canvas, int left, int right);
+    void rememberDrawnState();
     
     // Transform data coordinates to canvas coordinates
     void dataToCanvas(double x, double y, float& canvasX, float& canvasY) const;
     
     PlotConfig config_;
-    std::vector<DataSeries> series_;
-    std::unique_ptr<SkSurface> surface_;
+    std::vector<std::shared_ptr<DataSeries>> series_;
+    std::unique_ptr<RasterState> raster_;  // Surface, density image, static layer
+    std::unique_ptr<ThreadPool> pool_;
+    std::shared_ptr<const RenderResources> resources_;
+    std::unique_ptr<MarkerCache> markers_;
+    std::unique_ptr<TextCache> text_;
+    std::unique_ptr<RenderArena> arena_;
+    bool vectorTarget_ = false;
+    
+    // Null unless stats or tracing are on
+    std::unique_ptr<StatsRecorder> recorder_;
     
     // Data range for scaling
     double xMin_, xMax_, yMin_, yMax_;
-    bool rangeComputed_;
+    
+    // Data-to-canvas mapping derived from the range and margins
+    AxisTransform xTransform_, yTransform_;
+    
+    // What the surface currently shows, for incremental rendering
+    struct DrawnSeries {
+        const DataSeries* series;
+        uint64_t revision;
+        uint64_t removed;
+        uint64_t end;
+        double firstX;
+        double lastX;
+    };
+    std::vector<DrawnSeries> drawnSeries_;
+    PlotConfig drawnConfig_;
+    double drawnRange_[4] = {0.0, 0.0, 0.0, 0.0};
+    const SkSurface* drawnSurface_ = nullptr;
+    
+    // Config and range the static layer was drawn for
+    PlotConfig layerConfig_;
+    double layerRange_[4] = {0.0, 0.0, 0.0, 0.0};
+    bool layerKeyed_ = false;
     
     void computeDataRange();
+    void updateTransforms();
+    void countPointsIn();
+    void buildSeriesPaths(std::vector<SkPath>& paths, float tolerance);
+    bool writeImage(SkWStream* stream, const std::string& name, const EncodeOptions& options);
+    bool writeVector(SkWStream* stream, const std::string& name, ImageFormat format,
+                     const EncodeOptions& options);
+    
+    // Batch rendering: take over a job's config and series, drawing into
+    // the given surface (null for vector output) with shared resources
+    void loadJob(PlotJob& job, std::shared_ptr<const RenderResources> resources,
+                 SkSurface* surface);
+    
+    friend class PlotBatch;
+    friend class PlotPipeline;
+    friend class Figure;
+};
+
+/**
+ * @brief One chart rendered by a PlotBatch or PlotPipeline
+ */
+struct PlotJob {
+    PlotConfig config;
+    std::vector<DataSeries> series;
+    std::string filename;
+    EncodeOptions encode;
+};
+
+/**
+ * @brief Throughput counters of a PlotBatch
+ */
+struct BatchStats {
+    size_t chartsRendered = 0;
+    size_t chartsFailed = 0;
+    double seconds = 0.0;  // Wall time spent rendering and writing
+    
+    double chartsPerSecond() const { return seconds > 0.0 ? chartsRendered / seconds : 0.0; }
+};
+
+/**
+ * @brief Renders many charts to image files with shared resources.
+ *
+ * Jobs are queued with submit() and rendered by flush(), which also runs
+ * automatically once maxQueuedJobs are waiting, so memory stays bounded by
+ * the queue length. Surfaces are pooled by size, fonts and shaped text are
+ * shared, and each worker reuses its Plot and scratch buffers, so rendering
+ * allocates little per chart. Encoding does allocate per chart: the encoder
+ * keeps its own state and writes straight into the output file.
+ */
+class PlotBatch {
+public:
+    explicit PlotBatch(int threads = 1, size_t maxQueuedJobs = 256);
+    ~PlotBatch();
+    
+    // Queue a job; returns false if a triggered flush had failures
+    bool submit(PlotJob job);
+    
+    // Render and write all queued jobs; returns false if any failed
+    bool flush();
+    
+    const BatchStats& getStats() const { return stats_; }
+
+private:
+    bool renderJob(BatchSlot& slot, PlotJob& job);
+    
+    size_t maxQueuedJobs_;
+    std::vector<PlotJob> queue_;
+    std::unique_ptr<ThreadPool> pool_;
+    std::unique_ptr<SurfacePool> surfaces_;
+    std::shared_ptr<const RenderResources> resources_;
+    std::vector<std::unique_ptr<BatchSlot>> slots_;
+    BatchStats stats_;
+};
+
+/**
+ * @brief Thread counts and queue bounds of a PlotPipeline
+ */
+struct PipelineOptions {
+    int renderThreads = 0;   // 0 = one per hardware thread
+    int encodeThreads = 0;   // 0 = one per hardware thread
+    size_t queueDepth = 16;  // Jobs waiting in front of each stage
+};
+
+/**
+ * @brief Counters of a PlotPipeline; stage times are busy time summed over
+ * the stage's threads, so the largest one per thread marks the bottleneck
+ */
+struct PipelineStats {
+    size_t chartsWritten = 0;
+    size_t chartsFailed = 0;
+    double renderSeconds = 0.0;
+    double encodeSeconds = 0.0;
+    double writeSeconds = 0.0;
+};
+
+using PipelineCallback = std::function<void(const std::string& filename, bool ok)>;
+
+/**
+ * @brief Renders, encodes and writes charts as overlapping stages.
+ *
+ * Render threads rasterize submitted jobs into pooled surfaces, encode
+ * threads compress the pixels into memory, and a writer thread writes the
+ * files, so encoding and I/O overlap the rasterization of later charts.
+ * The stages are joined by bounded queues: a slow stage holds back the
+ * ones before it, and submit() blocks once queueDepth jobs are waiting, so
+ * memory stays bounded and throughput approaches the slowest stage. SVG
+ * and PDF jobs are drawn and encoded in one step on the render threads.
+ */
+class PlotPipeline {
+public:
+    explicit PlotPipeline(const PipelineOptions& options = PipelineOptions());
+    ~PlotPipeline();  // Finishes every submitted job
+    
+    // Queue a job; the future becomes true once the file is written
+    std::future<bool> submit(PlotJob job);
+    
+    // Queue a job; done runs on a pipeline thread when the job has been
+    // written or has failed, and must not call submit()
+    void submit(PlotJob job, PipelineCallback done);
+    
+    // Block until every submitted job has finished
+    void wait();
+    
+    PipelineStats getStats() const;
+
+private:
+    void enqueue(std::unique_ptr<PipelineItem> item);
+    void renderLoop();
+    void encodeLoop();
+    void writeLoop();
+    void finish(PipelineItem& item, bool ok);
+    
+    std::unique_ptr<PipelineState> state_;
+};
+
+/**
+ * @brief Grid layout of a Figure
+ */
+struct FigureConfig {
+    int rows = 1;
+    int columns = 1;
+    int panelWidth = 400;
+    int panelHeight = 300;
+    int spacing = 0;                        // Pixels between and around panels
+    uint32_t backgroundColor = 0xFFFFFFFF;  // Shows through the spacing
+    int renderThreads = 0;                  // Panels in parallel; 0 = hardware threads
+};
+
+/**
+ * @brief A grid of plots drawn onto one surface and encoded as one image.
+ *
+ * Each panel is a Plot rendered straight into its subregion of the shared
+ * surface, so an N-panel report needs one pixel buffer and one encode
+ * instead of N, and no compositing afterwards. Panels share fonts and
+ * other render resources and are rendered in parallel. Panel sizes come
+ * from the FigureConfig; width, height and renderThreads set on a panel's
+ * own config are overridden.
+ */
+class Figure {
+public:
+    explicit Figure(const FigureConfig& config = FigureConfig());
+    ~Figure();
+    
+    // The plot at a grid position, row 0 at the top
+    Plot& panel(int row, int column);
+    
+    const FigureConfig& getConfig() const { return config_; }
+    int getWidth() const;
+    int getHeight() const;
+    
+    // Render every panel; returns false if any of them failed
+    bool render();
+    
+    // Render and encode the whole figure; raster formats only
+    bool saveToFile(const std::string& filename, const EncodeOptions& options = EncodeOptions());
+    bool saveToStream(SkWStream& stream, const EncodeOptions& options = EncodeOptions());
+
+private:
+    void warmSeriesCaches();
+    bool writeImage(SkWStream* stream, const std::string& name, const EncodeOptions& options);
+    
+    FigureConfig config_;
+    std::vector<std::unique_ptr<Plot>> panels_;
+    std::shared_ptr<const RenderResources> resources_;
+    std::unique_ptr<ThreadPool> pool_;
+    std::unique_ptr<RasterState> raster_;
 };
 
 /**
@@ -136,6 +965,13 @@ namespace Utils {
      */
     std::vector<Point> linspace(double start, double end, int num);
     
+    /**
+     * @brief Sample fn at num evenly spaced x from start to end into a
+     * uniform-x series, without materializing the x values
+     */
+    DataSeries sampleFunction(const std::function<double(double)>& fn, double start,
+                              double end, int num, const std::string& name = "Data");
+    
     /**
      * @brief Create a simple line plot
      */
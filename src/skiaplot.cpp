@@ -5,391 +5,5490 @@
 #include "include/core/SkPath.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontMetrics.h"
+#include "include/core/SkTextBlob.h"
 #include "include/core/SkData.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkPngEncoder.h"
+#include "include/encode/SkJpegEncoder.h"
+#include "include/encode/SkWebpEncoder.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRSXform.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkDocument.h"
+#include "include/docs/SkPDFDocument.h"
+#include "include/svg/SkSVGCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkPixmap.h"
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <functional>
 #include <limits>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <iomanip>
+#include <thread>
+#include <type_traits>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// SIMD kernels: SSE2 is part of the x86-64 baseline and NEON of AArch64;
+// AVX2 is compiled per function and enabled after a runtime CPU check.
+// Define SKIAPLOT_NO_SIMD to build only the scalar kernels. The NEON log10
+// kernel has not yet been checked against the scalar one on ARM hardware,
+// so it is only built with SKIAPLOT_NEON_LOG.
+#if !defined(SKIAPLOT_NO_SIMD)
+#if defined(__x86_64__) || defined(_M_X64)
+#define SKIAPLOT_X86_SIMD
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SKIAPLOT_AVX2
+#define SKIAPLOT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SKIAPLOT_NEON_SIMD
+#include <arm_neon.h>
+#endif
+#endif
 
 namespace SkiaPlot {
 
+// ============================================================================
+// Batch Kernels
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Whole-array kernels for the two hottest per-point loops: min/max
+ * reduction for data ranges and the data-to-canvas transform.
+ *
+ * Each kernel has a scalar reference version plus SSE2/AVX2 (x86) or NEON
+ * (AArch64) versions; the widest one the CPU supports is picked once at
+ * startup. All versions evaluate offset + (v - origin) * scale in double
+ * without fused multiply-add, so they produce bit-identical canvas
+ * coordinates. NaNs are skipped by the reductions; a column with no
+ * other values reports a NaN range.
+ *
+ * The in-place log10 kernels feed log and symlog axes. They have scalar,
+ * SSE2 and AVX2 versions, which again agree to the bit with each other and
+ * with AxisTransform::forward(), plus an opt-in NEON version (see
+ * SKIAPLOT_NEON_LOG).
+ */
+struct Kernels {
+    void (*minMax64)(const double* values, size_t count, double& min, double& max);
+    void (*minMax32)(const float* values, size_t count, double& min, double& max);
+    void (*transform64)(const double* values, size_t count, const AxisTransform& t, float* out);
+    void (*transform32)(const float* values, size_t count, const AxisTransform& t, float* out);
+    void (*log10)(double* values, size_t count);        // Log10 axis values
+    void (*signedLog10)(double* values, size_t count);  // SymLog, |values| >= 1
+};
+
+// Log axes clip values at or below zero (and subnormals) to this, below
+// log10 of the smallest normal double, so they stay under all real data
+constexpr double kLog10Floor = -330.0;
+
+constexpr double kSqrt2 = 1.4142135623730951;
+constexpr double kLn2 = 0.6931471805599453;
+constexpr double kLog10E = 0.4342944819032518;
+
+/**
+ * @brief log10 of a positive finite double without a libm call or branches:
+ * the exponent comes from the bits, the mantissa is reduced to
+ * [sqrt(1/2), sqrt(2)) and its log is a short atanh series, accurate to
+ * about 1e-12.
+ */
+inline double log10Positive(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    double exponent = static_cast<double>(static_cast<int>((bits >> 52) & 0x7ff) - 1023);
+    uint64_t mantissaBits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+    double m;
+    std::memcpy(&m, &mantissaBits, sizeof(m));
+    
+    bool high = m > kSqrt2;
+    m = high ? m * 0.5 : m;
+    exponent += high ? 1.0 : 0.0;
+    
+    // ln(m) = 2 * atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172
+    double s = (m - 1.0) / (m + 1.0);
+    double s2 = s * s;
+    double series = 1.0 / 13.0;
+    series = series * s2 + 1.0 / 11.0;
+    series = series * s2 + 1.0 / 9.0;
+    series = series * s2 + 1.0 / 7.0;
+    series = series * s2 + 1.0 / 5.0;
+    series = series * s2 + 1.0 / 3.0;
+    series = series * s2 + 1.0;
+    return (exponent * kLn2 + 2.0 * s * series) * kLog10E;
+}
+
+// Log10 axis value: NaN stays NaN, non-positive values go to the floor
+inline double scaleLog10(double value) {
+    if (value != value) {
+        return value;
+    }
+    return value >= std::numeric_limits<double>::min() ? log10Positive(value) : kLog10Floor;
+}
+
+// sign(value) * log10(|value|) for |value| >= 1; NaN stays NaN
+inline double scaleSignedLog10(double value) {
+    if (value != value) {
+        return value;
+    }
+    return std::copysign(log10Positive(std::fabs(value)), value);
+}
+
+template <bool kSigned>
+void log10Tail(double* values, size_t begin, size_t count) {
+    for (size_t i = begin; i < count; ++i) {
+        values[i] = kSigned ? scaleSignedLog10(values[i]) : scaleLog10(values[i]);
+    }
+}
+
+template <bool kSigned>
+void log10Scalar(double* values, size_t count) {
+    log10Tail<kSigned>(values, 0, count);
+}
+
+template <typename T>
+void minMaxTail(const T* values, size_t begin, size_t count, double& min, double& max) {
+    for (size_t i = begin; i < count; ++i) {
+        double v = values[i];
+        if (v < min) min = v;
+        if (v > max) max = v;
+    }
+}
+
+void finishMinMax(double& min, double& max) {
+    if (min > max) {
+        min = max = std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+template <typename T>
+void transformTail(const T* values, size_t begin, size_t count, const AxisTransform& t,
+                   float* out) {
+    for (size_t i = begin; i < count; ++i) {
+        out[i] = static_cast<float>(t.offset + (static_cast<double>(values[i]) - t.origin) * t.scale);
+    }
+}
+
+template <typename T>
+void minMaxScalar(const T* values, size_t count, double& min, double& max) {
+    min = std::numeric_limits<double>::infinity();
+    max = -std::numeric_limits<double>::infinity();
+    minMaxTail(values, 0, count, min, max);
+    finishMinMax(min, max);
+}
+
+template <typename T>
+void transformScalar(const T* values, size_t count, const AxisTransform& t, float* out) {
+    transformTail(values, 0, count, t, out);
+}
+
+#if defined(SKIAPLOT_X86_SIMD)
+
+// _mm_min/_mm_max return their second operand when either input is NaN, so
+// keeping the accumulator second skips NaN inputs.
+
+void minMax64Sse2(const double* values, size_t count, double& min, double& max) {
+    __m128d vmin = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    __m128d vmax = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(values + i);
+        vmin = _mm_min_pd(v, vmin);
+        vmax = _mm_max_pd(v, vmax);
+    }
+    
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, vmin);
+    min = std::min(lanes[0], lanes[1]);
+    _mm_store_pd(lanes, vmax);
+    max = std::max(lanes[0], lanes[1]);
+    minMaxTail(values, i, count, min, max);
+    finishMinMax(min, max);
+}
+
+void minMax32Sse2(const float* values, size_t count, double& min, double& max) {
+    __m128 vmin = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    __m128 vmax = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(values + i);
+        vmin = _mm_min_ps(v, vmin);
+        vmax = _mm_max_ps(v, vmax);
+    }
+    
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, vmin);
+    min = *std::min_element(lanes, lanes + 4);
+    _mm_store_ps(lanes, vmax);
+    max = *std::max_element(lanes, lanes + 4);
+    minMaxTail(values, i, count, min, max);
+    finishMinMax(min, max);
+}
+
+void transform64Sse2(const double* values, size_t count, const AxisTransform& t, float* out) {
+    __m128d origin = _mm_set1_pd(t.origin);
+    __m128d scale = _mm_set1_pd(t.scale);
+    __m128d offset = _mm_set1_pd(t.offset);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(values + i);
+        __m128d r = _mm_add_pd(offset, _mm_mul_pd(_mm_sub_pd(v, origin), scale));
+        _mm_storel_pi(reinterpret_cast<__m64*>(out + i), _mm_cvtpd_ps(r));
+    }
+    transformTail(values, i, count, t, out);
+}
+
+void transform32Sse2(const float* values, size_t count, const AxisTransform& t, float* out) {
+    __m128d origin = _mm_set1_pd(t.origin);
+    __m128d scale = _mm_set1_pd(t.scale);
+    __m128d offset = _mm_set1_pd(t.offset);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(values + i);
+        __m128d lo = _mm_cvtps_pd(v);
+        __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+        lo = _mm_add_pd(offset, _mm_mul_pd(_mm_sub_pd(lo, origin), scale));
+        hi = _mm_add_pd(offset, _mm_mul_pd(_mm_sub_pd(hi, origin), scale));
+        _mm_storeu_ps(out + i, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+    }
+    transformTail(values, i, count, t, out);
+}
+
+// Lanes of a where mask is set, else of b; SSE2 has no blend instruction
+inline __m128d selectSse2(__m128d mask, __m128d a, __m128d b) {
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+// log10Positive() two lanes at a time, as in log10Avx2()
+template <bool kSigned>
+void log10Sse2(double* values, size_t count) {
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d sqrt2 = _mm_set1_pd(kSqrt2);
+    const __m128d signBit = _mm_set1_pd(-0.0);
+    const __m128d floor = _mm_set1_pd(kLog10Floor);
+    const __m128d minNormal = _mm_set1_pd(std::numeric_limits<double>::min());
+    const __m128d bias = _mm_set1_pd(4503599627370496.0 + 1023.0);
+    const __m128i twoTo52 = _mm_castpd_si128(_mm_set1_pd(4503599627370496.0));
+    const __m128i fieldMask = _mm_set1_epi64x(0x7ff);
+    const __m128i mantissaMask = _mm_set1_epi64x(0x000fffffffffffffLL);
+    const __m128i oneBits = _mm_castpd_si128(one);
+    const double coefficients[6] = {1.0 / 11.0, 1.0 / 9.0, 1.0 / 7.0, 1.0 / 5.0, 1.0 / 3.0, 1.0};
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(values + i);
+        __m128d magnitude = kSigned ? _mm_andnot_pd(signBit, v) : v;
+        __m128i bits = _mm_castpd_si128(magnitude);
+        __m128i field = _mm_and_si128(_mm_srli_epi64(bits, 52), fieldMask);
+        __m128d exponent = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(field, twoTo52)), bias);
+        __m128d m = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, mantissaMask), oneBits));
+        
+        __m128d high = _mm_cmpgt_pd(m, sqrt2);
+        m = selectSse2(high, _mm_mul_pd(m, half), m);
+        exponent = _mm_add_pd(exponent, _mm_and_pd(high, one));
+        
+        __m128d s = _mm_div_pd(_mm_sub_pd(m, one), _mm_add_pd(m, one));
+        __m128d s2 = _mm_mul_pd(s, s);
+        __m128d series = _mm_set1_pd(1.0 / 13.0);
+        for (double c : coefficients) {
+            series = _mm_add_pd(_mm_mul_pd(series, s2), _mm_set1_pd(c));
+        }
+        __m128d logM = _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(2.0), s), series);
+        __m128d r = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(exponent, _mm_set1_pd(kLn2)), logM),
+                               _mm_set1_pd(kLog10E));
+        
+        if (kSigned) {
+            r = _mm_or_pd(r, _mm_and_pd(signBit, v));
+        } else {
+            r = selectSse2(_mm_cmpge_pd(v, minNormal), r, floor);
+        }
+        r = selectSse2(_mm_cmpunord_pd(v, v), v, r);
+        _mm_storeu_pd(values + i, r);
+    }
+    log10Tail<kSigned>(values, i, count);
+}
+
+#if defined(SKIAPLOT_AVX2)
+
+SKIAPLOT_TARGET_AVX2
+void minMax64Avx2(const double* values, size_t count, double& min, double& max) {
+    // Two accumulator pairs hide the min/max latency
+    __m256d vmin0 = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d vmax0 = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    __m256d vmin1 = vmin0, vmax1 = vmax0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d a = _mm256_loadu_pd(values + i);
+        __m256d b = _mm256_loadu_pd(values + i + 4);
+        vmin0 = _mm256_min_pd(a, vmin0);
+        vmax0 = _mm256_max_pd(a, vmax0);
+        vmin1 = _mm256_min_pd(b, vmin1);
+        vmax1 = _mm256_max_pd(b, vmax1);
+    }
+    
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_min_pd(vmin0, vmin1));
+    min = *std::min_element(lanes, lanes + 4);
+    _mm256_store_pd(lanes, _mm256_max_pd(vmax0, vmax1));
+    max = *std::max_element(lanes, lanes + 4);
+    minMaxTail(values, i, count, min, max);
+    finishMinMax(min, max);
+}
+
+SKIAPLOT_TARGET_AVX2
+void minMax32Avx2(const float* values, size_t count, double& min, double& max) {
+    __m256 vmin0 = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    __m256 vmax0 = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    __m256 vmin1 = vmin0, vmax1 = vmax0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_loadu_ps(values + i);
+        __m256 b = _mm256_loadu_ps(values + i + 8);
+        vmin0 = _mm256_min_ps(a, vmin0);
+        vmax0 = _mm256_max_ps(a, vmax0);
+        vmin1 = _mm256_min_ps(b, vmin1);
+        vmax1 = _mm256_max_ps(b, vmax1);
+    }
+    
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, _mm256_min_ps(vmin0, vmin1));
+    min = *std::min_element(lanes, lanes + 8);
+    _mm256_store_ps(lanes, _mm256_max_ps(vmax0, vmax1));
+    max = *std::max_element(lanes, lanes + 8);
+    minMaxTail(values, i, count, min, max);
+    finishMinMax(min, max);
+}
+
+SKIAPLOT_TARGET_AVX2
+void transform64Avx2(const double* values, size_t count, const AxisTransform& t, float* out) {
+    __m256d origin = _mm256_set1_pd(t.origin);
+    __m256d scale = _mm256_set1_pd(t.scale);
+    __m256d offset = _mm256_set1_pd(t.offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d a = _mm256_loadu_pd(values + i);
+        __m256d b = _mm256_loadu_pd(values + i + 4);
+        a = _mm256_add_pd(offset, _mm256_mul_pd(_mm256_sub_pd(a, origin), scale));
+        b = _mm256_add_pd(offset, _mm256_mul_pd(_mm256_sub_pd(b, origin), scale));
+        _mm256_storeu_ps(out + i, _mm256_set_m128(_mm256_cvtpd_ps(b), _mm256_cvtpd_ps(a)));
+    }
+    transformTail(values, i, count, t, out);
+}
+
+SKIAPLOT_TARGET_AVX2
+void transform32Avx2(const float* values, size_t count, const AxisTransform& t, float* out) {
+    __m256d origin = _mm256_set1_pd(t.origin);
+    __m256d scale = _mm256_set1_pd(t.scale);
+    __m256d offset = _mm256_set1_pd(t.offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_loadu_ps(values + i);
+        __m256d a = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+        __m256d b = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+        a = _mm256_add_pd(offset, _mm256_mul_pd(_mm256_sub_pd(a, origin), scale));
+        b = _mm256_add_pd(offset, _mm256_mul_pd(_mm256_sub_pd(b, origin), scale));
+        _mm256_storeu_ps(out + i, _mm256_set_m128(_mm256_cvtpd_ps(b), _mm256_cvtpd_ps(a)));
+    }
+    transformTail(values, i, count, t, out);
+}
+
+// log10Positive() four lanes at a time, with the same operations in the same
+// order; the exponent field is turned into a double by placing it in the
+// mantissa of 2^52
+template <bool kSigned>
+SKIAPLOT_TARGET_AVX2
+void log10Avx2(double* values, size_t count) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d sqrt2 = _mm256_set1_pd(kSqrt2);
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    const __m256d floor = _mm256_set1_pd(kLog10Floor);
+    const __m256d minNormal = _mm256_set1_pd(std::numeric_limits<double>::min());
+    const __m256d bias = _mm256_set1_pd(4503599627370496.0 + 1023.0);
+    const __m256i twoTo52 = _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.0));
+    const __m256i fieldMask = _mm256_set1_epi64x(0x7ff);
+    const __m256i mantissaMask = _mm256_set1_epi64x(0x000fffffffffffffLL);
+    const __m256i oneBits = _mm256_castpd_si256(one);
+    const double coefficients[6] = {1.0 / 11.0, 1.0 / 9.0, 1.0 / 7.0, 1.0 / 5.0, 1.0 / 3.0, 1.0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d v = _mm256_loadu_pd(values + i);
+        __m256d magnitude = kSigned ? _mm256_andnot_pd(signBit, v) : v;
+        __m256i bits = _mm256_castpd_si256(magnitude);
+        __m256i field = _mm256_and_si256(_mm256_srli_epi64(bits, 52), fieldMask);
+        __m256d exponent = _mm256_sub_pd(
+            _mm256_castsi256_pd(_mm256_or_si256(field, twoTo52)), bias);
+        __m256d m = _mm256_castsi256_pd(
+            _mm256_or_si256(_mm256_and_si256(bits, mantissaMask), oneBits));
+        
+        __m256d high = _mm256_cmp_pd(m, sqrt2, _CMP_GT_OQ);
+        m = _mm256_blendv_pd(m, _mm256_mul_pd(m, half), high);
+        exponent = _mm256_add_pd(exponent, _mm256_and_pd(high, one));
+        
+        __m256d s = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+        __m256d s2 = _mm256_mul_pd(s, s);
+        __m256d series = _mm256_set1_pd(1.0 / 13.0);
+        for (double c : coefficients) {
+            series = _mm256_add_pd(_mm256_mul_pd(series, s2), _mm256_set1_pd(c));
+        }
+        __m256d logM = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), s), series);
+        __m256d r = _mm256_mul_pd(
+            _mm256_add_pd(_mm256_mul_pd(exponent, _mm256_set1_pd(kLn2)), logM),
+            _mm256_set1_pd(kLog10E));
+        
+        if (kSigned) {
+            r = _mm256_or_pd(r, _mm256_and_pd(signBit, v));
+        } else {
+            r = _mm256_blendv_pd(floor, r, _mm256_cmp_pd(v, minNormal, _CMP_GE_OQ));
+        }
+        r = _mm256_blendv_pd(r, v, _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+        _mm256_storeu_pd(values + i, r);
+    }
+    log10Tail<kSigned>(values, i, count);
+}
+
+#endif // SKIAPLOT_AVX2
+
+#elif defined(SKIAPLOT_NEON_SIMD)
+
+// vminnm/vmaxnm return the non-NaN operand, so NaN inputs are skipped.
+
+void minMax64Neon(const double* values, size_t count, double& min, double& max) {
+    float64x2_t vmin = vdupq_n_f64(std::numeric_limits<double>::infinity());
+    float64x2_t vmax = vdupq_n_f64(-std::numeric_limits<double>::infinity());
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        float64x2_t v = vld1q_f64(values + i);
+        vmin = vminnmq_f64(vmin, v);
+        vmax = vmaxnmq_f64(vmax, v);
+    }
+    min = vminnmvq_f64(vmin);
+    max = vmaxnmvq_f64(vmax);
+    minMaxTail(values, i, count, min, max);
+    finishMinMax(min, max);
+}
+
+void minMax32Neon(const float* values, size_t count, double& min, double& max) {
+    float32x4_t vmin = vdupq_n_f32(std::numeric_limits<float>::infinity());
+    float32x4_t vmax = vdupq_n_f32(-std::numeric_limits<float>::infinity());
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vld1q_f32(values + i);
+        vmin = vminnmq_f32(vmin, v);
+        vmax = vmaxnmq_f32(vmax, v);
+    }
+    min = vminnmvq_f32(vmin);
+    max = vmaxnmvq_f32(vmax);
+    minMaxTail(values, i, count, min, max);
+    finishMinMax(min, max);
+}
+
+void transform64Neon(const double* values, size_t count, const AxisTransform& t, float* out) {
+    float64x2_t origin = vdupq_n_f64(t.origin);
+    float64x2_t scale = vdupq_n_f64(t.scale);
+    float64x2_t offset = vdupq_n_f64(t.offset);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float64x2_t a = vld1q_f64(values + i);
+        float64x2_t b = vld1q_f64(values + i + 2);
+        a = vaddq_f64(offset, vmulq_f64(vsubq_f64(a, origin), scale));
+        b = vaddq_f64(offset, vmulq_f64(vsubq_f64(b, origin), scale));
+        vst1q_f32(out + i, vcombine_f32(vcvt_f32_f64(a), vcvt_f32_f64(b)));
+    }
+    transformTail(values, i, count, t, out);
+}
+
+void transform32Neon(const float* values, size_t count, const AxisTransform& t, float* out) {
+    float64x2_t origin = vdupq_n_f64(t.origin);
+    float64x2_t scale = vdupq_n_f64(t.scale);
+    float64x2_t offset = vdupq_n_f64(t.offset);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vld1q_f32(values + i);
+        float64x2_t a = vcvt_f64_f32(vget_low_f32(v));
+        float64x2_t b = vcvt_high_f64_f32(v);
+        a = vaddq_f64(offset, vmulq_f64(vsubq_f64(a, origin), scale));
+        b = vaddq_f64(offset, vmulq_f64(vsubq_f64(b, origin), scale));
+        vst1q_f32(out + i, vcombine_f32(vcvt_f32_f64(a), vcvt_f32_f64(b)));
+    }
+    transformTail(values, i, count, t, out);
+}
+
+#if defined(SKIAPLOT_NEON_LOG)
+
+// log10Positive() two lanes at a time, as in log10Avx2()
+template <bool kSigned>
+void log10Neon(double* values, size_t count) {
+    const float64x2_t one = vdupq_n_f64(1.0);
+    const float64x2_t half = vdupq_n_f64(0.5);
+    const float64x2_t sqrt2 = vdupq_n_f64(kSqrt2);
+    const float64x2_t floor = vdupq_n_f64(kLog10Floor);
+    const float64x2_t minNormal = vdupq_n_f64(std::numeric_limits<double>::min());
+    const float64x2_t bias = vdupq_n_f64(4503599627370496.0 + 1023.0);
+    const uint64x2_t twoTo52 = vreinterpretq_u64_f64(vdupq_n_f64(4503599627370496.0));
+    const uint64x2_t fieldMask = vdupq_n_u64(0x7ff);
+    const uint64x2_t mantissaMask = vdupq_n_u64(0x000fffffffffffffULL);
+    const uint64x2_t signBit = vdupq_n_u64(0x8000000000000000ULL);
+    const uint64x2_t oneBits = vreinterpretq_u64_f64(one);
+    const double coefficients[6] = {1.0 / 11.0, 1.0 / 9.0, 1.0 / 7.0, 1.0 / 5.0, 1.0 / 3.0, 1.0};
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        float64x2_t v = vld1q_f64(values + i);
+        float64x2_t magnitude = kSigned ? vabsq_f64(v) : v;
+        uint64x2_t bits = vreinterpretq_u64_f64(magnitude);
+        uint64x2_t field = vandq_u64(vshrq_n_u64(bits, 52), fieldMask);
+        float64x2_t exponent = vsubq_f64(vreinterpretq_f64_u64(vorrq_u64(field, twoTo52)), bias);
+        float64x2_t m = vreinterpretq_f64_u64(vorrq_u64(vandq_u64(bits, mantissaMask), oneBits));
+        
+        uint64x2_t high = vcgtq_f64(m, sqrt2);
+        m = vbslq_f64(high, vmulq_f64(m, half), m);
+        exponent = vaddq_f64(exponent, vreinterpretq_f64_u64(vandq_u64(high, oneBits)));
+        
+        float64x2_t s = vdivq_f64(vsubq_f64(m, one), vaddq_f64(m, one));
+        float64x2_t s2 = vmulq_f64(s, s);
+        float64x2_t series = vdupq_n_f64(1.0 / 13.0);
+        for (double c : coefficients) {
+            series = vaddq_f64(vmulq_f64(series, s2), vdupq_n_f64(c));
+        }
+        float64x2_t logM = vmulq_f64(vmulq_f64(vdupq_n_f64(2.0), s), series);
+        float64x2_t r = vmulq_f64(vaddq_f64(vmulq_f64(exponent, vdupq_n_f64(kLn2)), logM),
+                                  vdupq_n_f64(kLog10E));
+        
+        if (kSigned) {
+            uint64x2_t sign = vandq_u64(vreinterpretq_u64_f64(v), signBit);
+            r = vreinterpretq_f64_u64(vorrq_u64(vreinterpretq_u64_f64(r), sign));
+        } else {
+            r = vbslq_f64(vcgeq_f64(v, minNormal), r, floor);
+        }
+        r = vbslq_f64(vceqq_f64(v, v), r, v);
+        vst1q_f64(values + i, r);
+    }
+    log10Tail<kSigned>(values, i, count);
+}
+
+#endif // SKIAPLOT_NEON_LOG
+
+#endif
+
+Kernels selectKernels() {
+    Kernels k{minMaxScalar<double>, minMaxScalar<float>,
+              transformScalar<double>, transformScalar<float>,
+              log10Scalar<false>, log10Scalar<true>};
+#if defined(SKIAPLOT_X86_SIMD)
+    k = {minMax64Sse2, minMax32Sse2, transform64Sse2, transform32Sse2,
+         log10Sse2<false>, log10Sse2<true>};
+#if defined(SKIAPLOT_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        k = {minMax64Avx2, minMax32Avx2, transform64Avx2, transform32Avx2,
+             log10Avx2<false>, log10Avx2<true>};
+    }
+#endif
+#elif defined(SKIAPLOT_NEON_SIMD)
+#if defined(SKIAPLOT_NEON_LOG)
+    k = {minMax64Neon, minMax32Neon, transform64Neon, transform32Neon,
+         log10Neon<false>, log10Neon<true>};
+#else
+    k = {minMax64Neon, minMax32Neon, transform64Neon, transform32Neon,
+         log10Scalar<false>, log10Scalar<true>};
+#endif
+#endif
+    return k;
+}
+
+const Kernels& kernels() {
+    static const Kernels selected = selectKernels();
+    return selected;
+}
+
+void minMax(const double* values, size_t count, double& min, double& max) {
+    kernels().minMax64(values, count, min, max);
+}
+
+void minMax(const float* values, size_t count, double& min, double& max) {
+    kernels().minMax32(values, count, min, max);
+}
+
+void transform(const double* values, size_t count, const AxisTransform& t, float* out) {
+    kernels().transform64(values, count, t, out);
+}
+
+void transform(const float* values, size_t count, const AxisTransform& t, float* out) {
+    kernels().transform32(values, count, t, out);
+}
+
+/**
+ * @brief Maps count values through a nonlinear axis scale into out, the
+ * batch form of AxisTransform::forward(). out may alias values.
+ */
+template <typename T>
+void scaleValues(const T* values, size_t count, const AxisTransform& t, double* out) {
+    if (t.mapping == AxisScale::Log10) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<double>(values[i]);
+        }
+        kernels().log10(out, count);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            double v = static_cast<double>(values[i]);
+            out[i] = std::copysign(1.0 + std::fabs(v) / t.threshold, v);
+        }
+        kernels().signedLog10(out, count);
+    }
+}
+
+/**
+ * @brief transform() through the axis scale. Nonlinear axes are first
+ * scaled into scratch, which holds count doubles.
+ */
+template <typename T>
+void transformAxis(const T* values, size_t count, const AxisTransform& t, double* scratch,
+                   float* out) {
+    if (t.isLinear()) {
+        transform(values, count, t, out);
+        return;
+    }
+    scaleValues(values, count, t, scratch);
+    transform(scratch, count, t, out);
+}
+
+/**
+ * @brief Transforms the grid values start + i * step for i in
+ * [begin, begin + count); the same arithmetic as transform(), but with
+ * nothing to load the plain loop vectorizes well.
+ */
+void transformGrid(double start, double step, size_t begin, size_t count, const AxisTransform& t,
+                   float* out) {
+    for (size_t i = 0; i < count; ++i) {
+        double value = start + static_cast<double>(begin + i) * step;
+        out[i] = static_cast<float>(t.offset + (value - t.origin) * t.scale);
+    }
+}
+
+} // namespace
+
+double AxisTransform::forwardNonlinear(double value) const {
+    if (mapping == AxisScale::Log10) {
+        return scaleLog10(value);
+    }
+    return scaleSignedLog10(std::copysign(1.0 + std::fabs(value) / threshold, value));
+}
+
+double AxisTransform::inverseNonlinear(double scaled) const {
+    if (mapping == AxisScale::Log10) {
+        return std::pow(10.0, scaled);
+    }
+    return std::copysign(threshold * (std::pow(10.0, std::fabs(scaled)) - 1.0), scaled);
+}
+
 // ============================================================================
 // DataSeries Implementation
 // ============================================================================
 
-DataSeries::DataSeries(const std::string& name) : name_(name) {}
+namespace {
+
+/**
+ * @brief Calls fn(xs, ys, count) with the series columns cast to their
+ * stored element type, so hot loops are compiled once per type instead of
+ * branching on it per point. xs is null for uniform-x series.
+ */
+template <typename Fn>
+void visitColumns(const DataSeries& series, Fn&& fn) {
+    ColumnView x = series.xColumn();
+    ColumnView y = series.yColumn();
+    if (series.getValueType() == ValueType::Float64) {
+        fn(x.asFloat64(), y.asFloat64(), x.size);
+    } else {
+        fn(x.asFloat32(), y.asFloat32(), x.size);
+    }
+}
+
+/**
+ * @brief visitColumns() that also fixes the x layout at compile time: fn
+ * gets a fourth argument, std::true_type for uniform-x series and
+ * std::false_type otherwise, so kernels are instantiated once per column
+ * type and layout and choose with if constexpr instead of per batch.
+ */
+template <typename Fn>
+void visitLayout(const DataSeries& series, Fn&& fn) {
+    visitColumns(series, [&](const auto* xs, const auto* ys, size_t count) {
+        if (xs) {
+            fn(xs, ys, count, std::false_type());
+        } else {
+            fn(xs, ys, count, std::true_type());
+        }
+    });
+}
+
+// A NaN x compares false both ways, so binary search would skip whatever
+// follows it; a series with one is treated as unsorted
+template <typename T>
+bool isSortedFrom(const T* xs, size_t from, size_t count) {
+    for (size_t i = from; i < count; ++i) {
+        if (std::isnan(xs[i]) || (i > 0 && xs[i] < xs[i - 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Makes room for count more values while keeping geometric growth, so
+// many small appends stay amortized O(1) per value
+template <typename T>
+void growColumn(std::vector<T>& column, size_t count) {
+    size_t needed = column.size() + count;
+    if (needed > column.capacity()) {
+        column.reserve(std::max(needed, column.capacity() * 2));
+    }
+}
+
+// Smallest positive value, +inf if there is none
+template <typename T>
+double minPositiveOf(const T* values, size_t count) {
+    double result = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        double v = values[i];
+        if (v > 0.0 && v < result) result = v;
+    }
+    return result;
+}
+
+// minPositiveOf() for the grid start + i * step, i < count. The grid is
+// monotonic, so the answer is an end point or next to the zero crossing.
+double minPositiveOfGrid(double start, double step, size_t count) {
+    double result = std::numeric_limits<double>::infinity();
+    if (count == 0) {
+        return result;
+    }
+    double last = start + static_cast<double>(count - 1) * step;
+    double lo = std::min(start, last);
+    double hi = std::max(start, last);
+    if (lo > 0.0 || !(hi > 0.0)) {
+        return lo > 0.0 ? lo : result;
+    }
+    
+    // Check both sides of the crossing, allowing for rounding
+    double zero = std::floor(-start / step);
+    for (double i = zero - 1.0; i <= zero + 2.0; ++i) {
+        if (i >= 0.0 && i < static_cast<double>(count)) {
+            double v = start + i * step;
+            if (v > 0.0 && v < result) result = v;
+        }
+    }
+    return result;
+}
+
+template <typename T>
+void appendColumn(std::vector<T>& column, const void* data, ValueType type, size_t count) {
+    if (type == ValueType::Float64) {
+        const double* values = static_cast<const double*>(data);
+        column.insert(column.end(), values, values + count);
+    } else {
+        const float* values = static_cast<const float*>(data);
+        column.insert(column.end(), values, values + count);
+    }
+}
+
+} // namespace
+
+DataSeries::DataSeries(const std::string& name, ValueType type) : name_(name), type_(type) {}
+
+size_t DataSeries::size() const {
+    if (viewY_) {
+        return viewSize_;
+    }
+    return (type_ == ValueType::Float64 ? y64_.size() : y32_.size()) - head_;
+}
+
+ColumnView DataSeries::xColumn() const {
+    if (uniformX_) {
+        return {nullptr, type_, size(), true, x0_ + static_cast<double>(removed_) * dx_, dx_};
+    }
+    if (viewX_) {
+        return {viewX_, type_, viewSize_};
+    }
+    if (type_ == ValueType::Float64) {
+        return {x64_.data() + head_, type_, x64_.size() - head_};
+    }
+    return {x32_.data() + head_, type_, x32_.size() - head_};
+}
+
+ColumnView DataSeries::yColumn() const {
+    if (viewY_) {
+        return {viewY_, type_, viewSize_};
+    }
+    if (type_ == ValueType::Float64) {
+        return {y64_.data() + head_, type_, y64_.size() - head_};
+    }
+    return {y32_.data() + head_, type_, y32_.size() - head_};
+}
 
 void DataSeries::addPoint(double x, double y) {
-    points_.emplace_back(x, y);
+    detachView();
+    storeX();
+    if (type_ == ValueType::Float64) {
+        x64_.push_back(x);
+        y64_.push_back(y);
+    } else {
+        x32_.push_back(static_cast<float>(x));
+        y32_.push_back(static_cast<float>(y));
+    }
+    pointsChanged(size() - 1);
 }
 
 void DataSeries::addPoints(const std::vector<Point>& points) {
-    points_.insert(points_.end(), points.begin(), points.end());
+    detachView();
+    storeX();
+    size_t from = size();
+    if (type_ == ValueType::Float64) {
+        growColumn(x64_, points.size());
+        growColumn(y64_, points.size());
+        for (const auto& p : points) {
+            x64_.push_back(p.x);
+            y64_.push_back(p.y);
+        }
+    } else {
+        growColumn(x32_, points.size());
+        growColumn(y32_, points.size());
+        for (const auto& p : points) {
+            x32_.push_back(static_cast<float>(p.x));
+            y32_.push_back(static_cast<float>(p.y));
+        }
+    }
+    pointsChanged(from);
+}
+
+void DataSeries::addPoints(Span<double> x, Span<double> y) {
+    detachView();
+    storeX();
+    size_t from = size();
+    size_t count = std::min(x.size(), y.size());
+    if (type_ == ValueType::Float64) {
+        appendColumn(x64_, x.data(), ValueType::Float64, count);
+        appendColumn(y64_, y.data(), ValueType::Float64, count);
+    } else {
+        appendColumn(x32_, x.data(), ValueType::Float64, count);
+        appendColumn(y32_, y.data(), ValueType::Float64, count);
+    }
+    pointsChanged(from);
+}
+
+void DataSeries::setPoints(const std::vector<Point>& points) {
+    clearStorage();
+    addPoints(points);
+}
+
+void DataSeries::setData(std::vector<double> x, std::vector<double> y) {
+    clearStorage();
+    type_ = ValueType::Float64;
+    size_t count = std::min(x.size(), y.size());
+    x64_ = std::move(x);
+    y64_ = std::move(y);
+    x64_.resize(count);
+    y64_.resize(count);
+    pointsChanged(0);
+}
+
+void DataSeries::setData(std::vector<float> x, std::vector<float> y) {
+    clearStorage();
+    type_ = ValueType::Float32;
+    size_t count = std::min(x.size(), y.size());
+    x32_ = std::move(x);
+    y32_ = std::move(y);
+    x32_.resize(count);
+    y32_.resize(count);
+    pointsChanged(0);
+}
+
+void DataSeries::setView(Span<double> x, Span<double> y, std::shared_ptr<const void> owner) {
+    clearStorage();
+    type_ = ValueType::Float64;
+    viewX_ = x.data();
+    viewY_ = y.data();
+    viewSize_ = std::min(x.size(), y.size());
+    viewOwner_ = std::move(owner);
+    pointsChanged(0);
+}
+
+void DataSeries::setView(Span<float> x, Span<float> y, std::shared_ptr<const void> owner) {
+    clearStorage();
+    type_ = ValueType::Float32;
+    viewX_ = x.data();
+    viewY_ = y.data();
+    viewSize_ = std::min(x.size(), y.size());
+    viewOwner_ = std::move(owner);
+    pointsChanged(0);
+}
+
+void DataSeries::setUniformData(double x0, double dx, std::vector<double> y) {
+    clearStorage();
+    type_ = ValueType::Float64;
+    uniformX_ = true;
+    x0_ = x0;
+    dx_ = dx;
+    y64_ = std::move(y);
+    pointsChanged(0);
+}
+
+void DataSeries::setUniformData(double x0, double dx, std::vector<float> y) {
+    clearStorage();
+    type_ = ValueType::Float32;
+    uniformX_ = true;
+    x0_ = x0;
+    dx_ = dx;
+    y32_ = std::move(y);
+    pointsChanged(0);
+}
+
+void DataSeries::setUniformView(double x0, double dx, Span<double> y,
+                                std::shared_ptr<const void> owner) {
+    clearStorage();
+    type_ = ValueType::Float64;
+    uniformX_ = true;
+    x0_ = x0;
+    dx_ = dx;
+    viewY_ = y.data();
+    viewSize_ = y.size();
+    viewOwner_ = std::move(owner);
+    pointsChanged(0);
+}
+
+void DataSeries::setUniformView(double x0, double dx, Span<float> y,
+                                std::shared_ptr<const void> owner) {
+    clearStorage();
+    type_ = ValueType::Float32;
+    uniformX_ = true;
+    x0_ = x0;
+    dx_ = dx;
+    viewY_ = y.data();
+    viewSize_ = y.size();
+    viewOwner_ = std::move(owner);
+    pointsChanged(0);
+}
+
+bool DataSeries::addValues(Span<double> y) {
+    if (!uniformX_) {
+        return false;
+    }
+    
+    detachView();
+    size_t from = size();
+    if (from == 0) {
+        // Appending to an empty series restarts the point numbering
+        x0_ += static_cast<double>(removed_) * dx_;
+    }
+    if (type_ == ValueType::Float64) {
+        appendColumn(y64_, y.data(), ValueType::Float64, y.size());
+    } else {
+        appendColumn(y32_, y.data(), ValueType::Float64, y.size());
+    }
+    pointsChanged(from);
+    return true;
+}
+
+void DataSeries::clear() {
+    clearStorage();
+    pointsChanged(0);
+}
+
+void DataSeries::reserve(size_t count) {
+    detachView();
+    size_t total = head_ + count;
+    if (type_ == ValueType::Float64) {
+        if (!uniformX_) x64_.reserve(total);
+        y64_.reserve(total);
+    } else {
+        if (!uniformX_) x32_.reserve(total);
+        y32_.reserve(total);
+    }
+}
+
+size_t DataSeries::capacity() const {
+    if (viewY_) {
+        return viewSize_;
+    }
+    return (type_ == ValueType::Float64 ? y64_.capacity() : y32_.capacity()) - head_;
+}
+
+void DataSeries::shrinkToFit() {
+    if (viewY_) {
+        return;
+    }
+    
+    // Drop the removed prefix first; point numbers are unaffected
+    compact();
+    x64_.shrink_to_fit();
+    y64_.shrink_to_fit();
+    x32_.shrink_to_fit();
+    y32_.shrink_to_fit();
+    pointsCache_.clear();
+    pointsCache_.shrink_to_fit();
+    pointsCacheValid_ = false;
+}
+
+void DataSeries::removeFront(size_t count) {
+    detachView();
+    count = std::min(count, size());
+    if (count == 0) {
+        return;
+    }
+    
+    head_ += count;
+    removed_ += count;
+    sortedCheckedTo_ -= std::min(sortedCheckedTo_, count);
+    pointsCacheValid_ = false;
+    rangeValid_ = false;
+    minPositiveValid_ = false;
+    
+    // Compact once the dead prefix outgrows the live points, so each point
+    // is moved at most once on average
+    size_t total = type_ == ValueType::Float64 ? y64_.size() : y32_.size();
+    if (head_ >= total - head_) {
+        compact();
+    }
+}
+
+void DataSeries::compact() {
+    // Uniform-x series have no x column
+    if (type_ == ValueType::Float64) {
+        x64_.erase(x64_.begin(), x64_.begin() + std::min(head_, x64_.size()));
+        y64_.erase(y64_.begin(), y64_.begin() + head_);
+    } else {
+        x32_.erase(x32_.begin(), x32_.begin() + std::min(head_, x32_.size()));
+        y32_.erase(y32_.begin(), y32_.begin() + head_);
+    }
+    head_ = 0;
+}
+
+void DataSeries::clearStorage() {
+    x64_.clear();
+    y64_.clear();
+    x32_.clear();
+    y32_.clear();
+    head_ = 0;
+    uniformX_ = false;
+    viewX_ = viewY_ = nullptr;
+    viewSize_ = 0;
+    viewOwner_.reset();
+}
+
+void DataSeries::detachView() {
+    if (!viewY_) {
+        return;
+    }
+    
+    // Copy the borrowed columns into owned storage before mutating; the
+    // owner must outlive the copy
+    const void* viewX = viewX_;
+    const void* viewY = viewY_;
+    size_t count = viewSize_;
+    bool uniformX = uniformX_;
+    std::shared_ptr<const void> owner = std::move(viewOwner_);
+    clearStorage();
+    uniformX_ = uniformX;
+    if (type_ == ValueType::Float64) {
+        if (viewX) appendColumn(x64_, viewX, type_, count);
+        appendColumn(y64_, viewY, type_, count);
+    } else {
+        if (viewX) appendColumn(x32_, viewX, type_, count);
+        appendColumn(y32_, viewY, type_, count);
+    }
+}
+
+void DataSeries::storeX() {
+    if (!uniformX_) {
+        return;
+    }
+    
+    // Fill the x column from the grid, including the removed prefix
+    ColumnView grid = xColumn();
+    size_t total = head_ + grid.size;
+    if (type_ == ValueType::Float64) {
+        x64_.resize(total);
+        for (size_t i = 0; i < total; ++i) {
+            x64_[i] = grid.start + (static_cast<double>(i) - static_cast<double>(head_)) * grid.step;
+        }
+    } else {
+        x32_.resize(total);
+        for (size_t i = 0; i < total; ++i) {
+            x32_[i] = static_cast<float>(
+                grid.start + (static_cast<double>(i) - static_cast<double>(head_)) * grid.step);
+        }
+    }
+    uniformX_ = false;
+    minPositiveValid_ = false;  // Its x was not cached while uniform
+}
+
+void DataSeries::pointsChanged(size_t from) {
+    pointsCacheValid_ = false;
+    if (from == 0) {
+        // Everything may have changed
+        ++revision_;
+        removed_ = 0;
+        rangeValid_ = false;
+        minPositiveValid_ = false;
+        sortedByX_ = true;
+        sortedCheckedTo_ = 0;
+    }
+    
+    // Extend the cached range by the appended points only
+    visitColumns(*this, [&](const auto* xs, const auto* ys, size_t count) {
+        if (rangeValid_ && from < count) {
+            double lo, hi;
+            if (xs) {
+                minMax(xs + from, count - from, lo, hi);
+                range_[0] = std::min(range_[0], lo);
+                range_[1] = std::max(range_[1], hi);
+            }
+            minMax(ys + from, count - from, lo, hi);
+            range_[2] = std::min(range_[2], lo);
+            range_[3] = std::max(range_[3], hi);
+        }
+        if (minPositiveValid_ && from < count) {
+            if (xs) {
+                minPositive_[0] = std::min(minPositive_[0], minPositiveOf(xs + from, count - from));
+            }
+            minPositive_[1] = std::min(minPositive_[1], minPositiveOf(ys + from, count - from));
+        }
+    });
+}
+
+bool DataSeries::isSortedByX() const {
+    if (uniformX_) {
+        return dx_ >= 0.0;
+    }
+    
+    // Only points appended since the last check need looking at
+    size_t count = size();
+    if (sortedByX_ && sortedCheckedTo_ < count) {
+        visitColumns(*this, [&](const auto* xs, const auto*, size_t n) {
+            sortedByX_ = isSortedFrom(xs, sortedCheckedTo_, n);
+        });
+        sortedCheckedTo_ = count;
+    }
+    return sortedByX_;
+}
+
+const std::vector<Point>& DataSeries::getPoints() const {
+    if (!pointsCacheValid_) {
+        pointsCache_.clear();
+        pointsCache_.reserve(size());
+        ColumnView grid = xColumn();
+        visitColumns(*this, [&](const auto* xs, const auto* ys, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                pointsCache_.emplace_back(xs ? static_cast<double>(xs[i]) : grid[i], ys[i]);
+            }
+        });
+        pointsCacheValid_ = true;
+    }
+    return pointsCache_;
+}
+
+void DataSeries::getRange(double& xMin, double& xMax, double& yMin, double& yMax) const {
+    if (empty()) {
+        xMin = xMax = yMin = yMax = 0.0;
+        return;
+    }
+    
+    size_t minIndex, maxIndex;
+    if (!rangeValid_ && pyramid_ && isSortedByX()) {
+        // Without a scan: x from the end points, y from the pyramid
+        range_[0] = x(0);
+        range_[1] = x(size() - 1);
+        range_[2] = range_[3] = std::numeric_limits<double>::quiet_NaN();
+        if (findYExtremes(0, size(), minIndex, maxIndex)) {
+            range_[2] = y(minIndex);
+            range_[3] = y(maxIndex);
+        }
+        rangeValid_ = true;
+    } else if (!rangeValid_) {
+        visitColumns(*this, [&](const auto* xs, const auto* ys, size_t count) {
+            if (xs) {
+                minMax(xs, count, range_[0], range_[1]);
+            }
+            minMax(ys, count, range_[2], range_[3]);
+        });
+        rangeValid_ = true;
+    }
+    
+    xMin = range_[0];
+    xMax = range_[1];
+    yMin = range_[2];
+    yMax = range_[3];
+    
+    if (uniformX_) {
+        // The grid end points bound x
+        double first = x(0);
+        double last = x(size() - 1);
+        xMin = std::min(first, last);
+        xMax = std::max(first, last);
+    }
+}
+
+void DataSeries::getMinPositive(double& xMin, double& yMin) const {
+    if (!minPositiveValid_) {
+        // The x of a uniform series is found from its grid below
+        double none = std::numeric_limits<double>::infinity();
+        visitColumns(*this, [&](const auto* xs, const auto* ys, size_t count) {
+            minPositive_[0] = xs ? minPositiveOf(xs, count) : none;
+            minPositive_[1] = minPositiveOf(ys, count);
+        });
+        minPositiveValid_ = true;
+    }
+    
+    double x = minPositive_[0];
+    if (uniformX_) {
+        ColumnView grid = xColumn();
+        x = minPositiveOfGrid(grid.start, grid.step, grid.size);
+    }
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    xMin = std::isinf(x) ? nan : x;
+    yMin = std::isinf(minPositive_[1]) ? nan : minPositive_[1];
+}
+
+// ============================================================================
+// StreamingSeries Implementation
+// ============================================================================
+
+StreamingSeries::StreamingSeries(const std::string& name, size_t capacity, double timeWindow,
+                                 ValueType type)
+    : DataSeries(name, type), capacity_(capacity), timeWindow_(timeWindow) {}
+
+void StreamingSeries::setCapacity(size_t capacity) {
+    capacity_ = capacity;
+    evict();
+}
+
+void StreamingSeries::setTimeWindow(double timeWindow) {
+    timeWindow_ = timeWindow;
+    evict();
+}
+
+void StreamingSeries::append(double x, double y) {
+    addPoint(x, y);
+    evict();
+}
+
+void StreamingSeries::append(Span<double> x, Span<double> y) {
+    addPoints(x, y);
+    evict();
+}
+
+void StreamingSeries::evict() {
+    size_t count = 0;
+    if (capacity_ > 0 && size() > capacity_) {
+        count = size() - capacity_;
+    }
+    
+    if (timeWindow_ > 0.0 && size() > count) {
+        // Points are time-ordered, so expired ones form a prefix
+        double cutoff = x(size() - 1) - timeWindow_;
+        while (count < size() && x(count) < cutoff) {
+            ++count;
+        }
+    }
+    
+    removeFront(count);
+}
+
+void StreamingSeries::getRange(double& xMin, double& xMax, double& yMin, double& yMax) const {
+    if (empty() || !isSortedByX()) {
+        DataSeries::getRange(xMin, xMax, yMin, yMax);
+        return;
+    }
+    
+    uint64_t first = getRemovedCount();
+    uint64_t end = first + size();
+    if (trackedRevision_ != getRevision() || trackedEnd_ < first) {
+        minQueue_.clear();
+        maxQueue_.clear();
+        trackedRevision_ = getRevision();
+        trackedEnd_ = first;
+    }
+    
+    // Push points appended since the last call; a candidate is dropped once
+    // a newer point is at least as extreme, since it will outlive it
+    ColumnView ys = yColumn();
+    for (uint64_t n = trackedEnd_; n < end; ++n) {
+        double v = ys[n - first];
+        if (std::isnan(v)) {
+            continue;
+        }
+        while (!minQueue_.empty() && ys[minQueue_.back() - first] >= v) {
+            minQueue_.pop_back();
+        }
+        minQueue_.push_back(n);
+        while (!maxQueue_.empty() && ys[maxQueue_.back() - first] <= v) {
+            maxQueue_.pop_back();
+        }
+        maxQueue_.push_back(n);
+    }
+    trackedEnd_ = end;
+    
+    // Drop candidates that have been evicted
+    while (!minQueue_.empty() && minQueue_.front() < first) {
+        minQueue_.pop_front();
+    }
+    while (!maxQueue_.empty() && maxQueue_.front() < first) {
+        maxQueue_.pop_front();
+    }
+    
+    // Sorted x: the range is given by the end points
+    xMin = x(0);
+    xMax = x(size() - 1);
+    if (minQueue_.empty()) {
+        yMin = yMax = std::numeric_limits<double>::quiet_NaN();
+    } else {
+        yMin = ys[minQueue_.front() - first];
+        yMax = ys[maxQueue_.front() - first];
+    }
+}
+
+// ============================================================================
+// Series File Implementation
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Read-only mapping of a whole file, unmapped on destruction.
+ */
+class MappedFile {
+public:
+    static std::shared_ptr<MappedFile> open(const std::string& path) {
+        std::shared_ptr<MappedFile> file(new MappedFile());
+        return file->map(path) ? file : nullptr;
+    }
+    
+    ~MappedFile() {
+#if defined(_WIN32)
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    const uint8_t* data() const { return data_; }
+    uint64_t size() const { return size_; }
+
+private:
+    MappedFile() = default;
+    
+    bool map(const std::string& path) {
+#if defined(_WIN32)
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER fileSize;
+        if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &fileSize)) {
+            return false;
+        }
+        size_ = static_cast<uint64_t>(fileSize.QuadPart);
+        if (size_ == 0) {
+            return true;
+        }
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_) {
+            return false;
+        }
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        return data_ != nullptr;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && st.st_size > 0) {
+            // The mapping stays valid after the descriptor is closed
+            size_ = static_cast<uint64_t>(st.st_size);
+            void* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            ok = data != MAP_FAILED;
+            data_ = ok ? static_cast<const uint8_t*>(data) : nullptr;
+        }
+        ::close(fd);
+        return ok;
+#endif
+    }
+    
+    const uint8_t* data_ = nullptr;
+    uint64_t size_ = 0;
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+// On-disk header of files written by writeSeriesFile(), little-endian
+constexpr char kSeriesFileMagic[4] = {'S', 'K', 'P', 'S'};
+constexpr uint32_t kSeriesFileVersion = 1;
+constexpr size_t kSeriesFileHeaderSize = 64;
+constexpr uint32_t kSeriesFileUniformX = 1;
+
+bool isLittleEndian() {
+    uint16_t probe = 1;
+    uint8_t firstByte;
+    std::memcpy(&firstByte, &probe, 1);
+    return firstByte == 1;
+}
+
+template <typename T>
+T readLE(const uint8_t* bytes) {
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void writeLE(uint8_t* bytes, T value) {
+    std::memcpy(bytes, &value, sizeof(T));
+}
+
+bool parseSeriesHeader(const MappedFile& file, SeriesFileInfo& info) {
+    const uint8_t* header = file.data();
+    if (file.size() < kSeriesFileHeaderSize ||
+        std::memcmp(header, kSeriesFileMagic, sizeof(kSeriesFileMagic)) != 0 ||
+        readLE<uint32_t>(header + 4) != kSeriesFileVersion) {
+        return false;
+    }
+    
+    uint32_t type = readLE<uint32_t>(header + 8);
+    if (type > 1) {
+        return false;
+    }
+    info.type = type == 0 ? ValueType::Float64 : ValueType::Float32;
+    info.uniformX = (readLE<uint32_t>(header + 12) & kSeriesFileUniformX) != 0;
+    info.count = readLE<uint64_t>(header + 16);
+    info.stride = readLE<uint64_t>(header + 24);
+    info.xOffset = readLE<uint64_t>(header + 32);
+    info.yOffset = readLE<uint64_t>(header + 40);
+    info.x0 = readLE<double>(header + 48);
+    info.dx = readLE<double>(header + 56);
+    return true;
+}
+
+// True if count values starting at offset, stride bytes apart, lie inside
+// a file of fileSize bytes (without overflowing)
+bool columnFits(uint64_t offset, uint64_t stride, uint64_t count, size_t valueSize,
+                uint64_t fileSize) {
+    if (count == 0) {
+        return offset <= fileSize;
+    }
+    if (offset > fileSize || valueSize > fileSize - offset) {
+        return false;
+    }
+    return (count - 1) <= (fileSize - offset - valueSize) / stride;
+}
+
+template <typename T>
+std::vector<T> copyColumn(const uint8_t* base, uint64_t stride, uint64_t count) {
+    std::vector<T> values(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        std::memcpy(&values[i], base + i * stride, sizeof(T));
+    }
+    return values;
+}
+
+template <typename T>
+bool mapColumns(const std::shared_ptr<MappedFile>& file, const SeriesFileInfo& info,
+                DataSeries& series) {
+    const uint8_t* data = file->data();
+    size_t count = static_cast<size_t>(info.count);
+    
+    // Packed, aligned columns are used in place
+    bool aligned = (info.uniformX || info.xOffset % alignof(T) == 0) &&
+                   info.yOffset % alignof(T) == 0 &&
+                   reinterpret_cast<uintptr_t>(data) % alignof(T) == 0;
+    if (info.stride == sizeof(T) && aligned) {
+        const T* ys = count ? reinterpret_cast<const T*>(data + info.yOffset) : nullptr;
+        if (info.uniformX) {
+            series.setUniformView(info.x0, info.dx, Span<T>(ys, count), file);
+        } else {
+            const T* xs = count ? reinterpret_cast<const T*>(data + info.xOffset) : nullptr;
+            series.setView(Span<T>(xs, count), Span<T>(ys, count), file);
+        }
+        return true;
+    }
+    
+    std::vector<T> ys = copyColumn<T>(data + info.yOffset, info.stride, count);
+    if (info.uniformX) {
+        series.setUniformData(info.x0, info.dx, std::move(ys));
+    } else {
+        series.setData(copyColumn<T>(data + info.xOffset, info.stride, count), std::move(ys));
+    }
+    return true;
+}
+
+} // namespace
+
+bool readSeriesFileInfo(const std::string& path, SeriesFileInfo& info) {
+    std::shared_ptr<MappedFile> file = MappedFile::open(path);
+    return file && parseSeriesHeader(*file, info);
+}
+
+bool openSeriesFile(const std::string& path, DataSeries& series) {
+    std::shared_ptr<MappedFile> file = MappedFile::open(path);
+    SeriesFileInfo info;
+    if (!file || !parseSeriesHeader(*file, info)) {
+        return false;
+    }
+    return openSeriesFile(path, info, series);
+}
+
+bool openSeriesFile(const std::string& path, const SeriesFileInfo& fileInfo,
+                    DataSeries& series) {
+    if (!isLittleEndian()) {
+        return false;
+    }
+    std::shared_ptr<MappedFile> file = MappedFile::open(path);
+    if (!file) {
+        return false;
+    }
+    
+    SeriesFileInfo info = fileInfo;
+    size_t valueSize = info.type == ValueType::Float64 ? sizeof(double) : sizeof(float);
+    if (info.stride == 0) {
+        info.stride = valueSize;
+    }
+    if (info.stride < valueSize) {
+        return false;
+    }
+    
+    // Infer the count and the y column of packed files
+    uint64_t columns = info.uniformX ? 1 : 2;
+    uint64_t dataStart = info.uniformX ? info.yOffset : info.xOffset;
+    if (info.count == 0 && info.stride == valueSize && file->size() > dataStart) {
+        info.count = (file->size() - dataStart) / (valueSize * columns);
+    }
+    if (!info.uniformX && info.yOffset == 0) {
+        info.yOffset = info.xOffset + info.count * info.stride;
+    }
+    if (info.count > std::numeric_limits<size_t>::max() / valueSize ||
+        !columnFits(info.yOffset, info.stride, info.count, valueSize, file->size()) ||
+        (!info.uniformX &&
+         !columnFits(info.xOffset, info.stride, info.count, valueSize, file->size()))) {
+        return false;
+    }
+    
+    if (info.type == ValueType::Float64) {
+        return mapColumns<double>(file, info, series);
+    }
+    return mapColumns<float>(file, info, series);
+}
+
+bool writeSeriesFile(const std::string& path, const DataSeries& series) {
+    if (!isLittleEndian()) {
+        return false;
+    }
+    
+    size_t count = series.size();
+    size_t valueSize = series.getValueType() == ValueType::Float64 ? sizeof(double)
+                                                                   : sizeof(float);
+    
+    // Uniform-x series store only the y column
+    ColumnView x = series.xColumn();
+    ColumnView y = series.yColumn();
+    size_t xBytes = x.uniform ? 0 : count * valueSize;
+    
+    uint8_t header[kSeriesFileHeaderSize] = {};
+    std::memcpy(header, kSeriesFileMagic, sizeof(kSeriesFileMagic));
+    writeLE<uint32_t>(header + 4, kSeriesFileVersion);
+    writeLE<uint32_t>(header + 8, series.getValueType() == ValueType::Float64 ? 0 : 1);
+    writeLE<uint32_t>(header + 12, x.uniform ? kSeriesFileUniformX : 0);
+    writeLE<uint64_t>(header + 16, count);
+    writeLE<uint64_t>(header + 24, valueSize);
+    writeLE<uint64_t>(header + 32, kSeriesFileHeaderSize);
+    writeLE<uint64_t>(header + 40, kSeriesFileHeaderSize + xBytes);
+    writeLE<double>(header + 48, x.uniform ? x.start : 0.0);
+    writeLE<double>(header + 56, x.uniform ? x.step : 1.0);
+    
+    SkFILEWStream stream(path.c_str());
+    if (!stream.isValid()) {
+        return false;
+    }
+    return stream.write(header, sizeof(header)) &&
+           (xBytes == 0 || stream.write(x.data, xBytes)) &&
+           stream.write(y.data, count * valueSize);
+}
+
+// ============================================================================
+// Decimation
+// ============================================================================
+
+namespace {
+
+// Decimation only pays off once a series averages more than this many points
+// per pixel column; below that M4 keeps nearly every point anyway.
+constexpr size_t kMinPointsPerColumnToDecimate = 4;
+
+// Strokes up to this width are drawn as hairlines, which have no joins; a
+// wider stroke's joins and antialiased edges depend on every vertex, so
+// dropping interior points of a column would change its shape, not only
+// the overdraw of its antialiased segments
+constexpr float kMaxDecimatedLineWidth = 1.0f;
+
+// Canvas columns further out than this are merged; nothing there is drawn
+constexpr float kMaxColumn = 1.0e15f;
+
+/**
+ * @brief floor() of a finite value within int range. Baseline x86-64 has
+ * no rounding instruction, so std::floor is a libm call per point in the
+ * hot loops; truncating and correcting negative values is exact.
+ */
+inline int floorToInt(float value) {
+    int truncated = static_cast<int>(value);
+    return truncated - (value < static_cast<float>(truncated) ? 1 : 0);
+}
+
+inline int64_t floorToInt64(float value) {
+    int64_t truncated = static_cast<int64_t>(value);
+    return truncated - (value < static_cast<float>(truncated) ? 1 : 0);
+}
+
+/**
+ * @brief Streams canvas points into a path, keeping per pixel column only the
+ * first, last, min-y and max-y point (M4 aggregation).
+ *
+ * The kept points are emitted in their original order, so the reduced
+ * polyline enters and leaves every column at the same place and spans the
+ * same vertical extent as the full one. Points must arrive sorted by x.
+ * A point with a non-finite coordinate ends the line; the next one starts
+ * a new contour, so missing values render as gaps.
+ */
+class M4Decimator {
+public:
+    struct Sample {
+        size_t index;
+        float x;
+        float y;
+    };
+    
+    explicit M4Decimator(SkPath& path) : path_(path) {}
+    
+    void add(size_t index, float x, float y) {
+        if (!std::isfinite(x) || !std::isfinite(y)) {
+            gap();
+            return;
+        }
+        
+        int64_t column = floorToInt64(std::clamp(x, -kMaxColumn, kMaxColumn));
+        Sample sample{index, x, y};
+        if (count_ == 0 || column != column_) {
+            flush();
+            column_ = column;
+            first_ = last_ = min_ = max_ = sample;
+            count_ = 1;
+            return;
+        }
+        
+        last_ = sample;
+        if (y < min_.y) min_ = sample;
+        if (y > max_.y) max_ = sample;
+        ++count_;
+    }
+    
+    // Adds a whole pixel column whose four points are already known
+    void addColumn(const Sample& first, const Sample& last, const Sample& min, const Sample& max) {
+        flush();
+        first_ = first;
+        last_ = last;
+        min_ = min;
+        max_ = max;
+        count_ = 1;
+        flush();
+    }
+    
+    // Ends the line; the next point starts a new contour
+    void gap() {
+        flush();
+        started_ = false;
+    }
+    
+    void flush() {
+        if (count_ == 0) {
+            return;
+        }
+        
+        Sample samples[4] = {first_, min_, max_, last_};
+        std::sort(samples, samples + 4,
+                  [](const Sample& a, const Sample& b) { return a.index < b.index; });
+        for (int i = 0; i < 4; ++i) {
+            if (i > 0 && samples[i].index == samples[i - 1].index) {
+                continue;
+            }
+            emit(samples[i]);
+        }
+        count_ = 0;
+    }
+
+private:
+    void emit(const Sample& sample) {
+        if (!std::isfinite(sample.x) || !std::isfinite(sample.y)) {
+            started_ = false;
+        } else if (started_) {
+            path_.lineTo(sample.x, sample.y);
+        } else {
+            path_.moveTo(sample.x, sample.y);
+            started_ = true;
+        }
+    }
+    
+    SkPath& path_;
+    bool started_ = false;
+    size_t count_ = 0;
+    int64_t column_ = 0;
+    Sample first_{}, last_{}, min_{}, max_{};
+};
+
+/**
+ * @brief Streams canvas points into a path, collapsing runs of points that
+ * stay beyond one edge of the visible rectangle.
+ *
+ * Every point of such a run lies in the same outer half-plane, so the
+ * straight segment from its first to its last point is as invisible as
+ * the run itself; only those two are kept. Segments that cross into the
+ * rectangle are emitted unchanged, so the clipped result is identical.
+ * A point with a non-finite coordinate ends the line, as in M4Decimator.
+ */
+class ViewportCuller {
+public:
+    ViewportCuller(SkPath& path, const SkRect& visible) : path_(path), visible_(visible) {}
+    
+    void add(float x, float y) {
+        if (!std::isfinite(x) || !std::isfinite(y)) {
+            flush();
+            started_ = false;
+            return;
+        }
+        
+        unsigned code = outcode(x, y);
+        if (started_ && (code & runCode_)) {
+            // Still beyond an edge the whole run shares
+            runCode_ &= code;
+            held_.set(x, y);
+            holding_ = true;
+            return;
+        }
+        
+        flush();
+        if (started_) {
+            path_.lineTo(x, y);
+        } else {
+            path_.moveTo(x, y);
+            started_ = true;
+        }
+        runCode_ = code;
+    }
+    
+    void flush() {
+        if (holding_) {
+            path_.lineTo(held_);
+            holding_ = false;
+        }
+    }
+
+private:
+    // One bit per edge the point is beyond
+    unsigned outcode(float x, float y) const {
+        return (x < visible_.fLeft ? 1u : 0u) | (x > visible_.fRight ? 2u : 0u) |
+               (y < visible_.fTop ? 4u : 0u) | (y > visible_.fBottom ? 8u : 0u);
+    }
+    
+    SkPath& path_;
+    SkRect visible_;
+    bool started_ = false;
+    bool holding_ = false;
+    unsigned runCode_ = 0;
+    SkPoint held_{};
+};
+
+// Points per batch transform; the float buffers of this size (and the
+// double scratch of nonlinear axes) stay in L1/L2
+constexpr size_t kTransformChunk = 4096;
+
+/**
+ * @brief Transforms a series to canvas coordinates in fixed-size batches and
+ * calls fn(begin, xs, ys, count) for each batch. Nonlinear axis scales are
+ * applied batch by batch too, so the series is never copied.
+ */
+template <typename Fn>
+void forEachCanvasChunk(const DataSeries& series, size_t first, size_t last,
+                        const AxisTransform& xTransform, const AxisTransform& yTransform,
+                        Fn&& fn) {
+    float xs[kTransformChunk];
+    float ys[kTransformChunk];
+    double scratch[kTransformChunk];
+    ColumnView grid = series.xColumn();
+    visitLayout(series, [&](const auto* dataX, const auto* dataY, size_t count, auto uniform) {
+        size_t end = std::min(last, count);
+        for (size_t begin = first; begin < end; begin += kTransformChunk) {
+            size_t n = std::min(kTransformChunk, end - begin);
+            if constexpr (decltype(uniform)::value) {
+                if (xTransform.isLinear()) {
+                    transformGrid(grid.start, grid.step, begin, n, xTransform, xs);
+                } else {
+                    for (size_t i = 0; i < n; ++i) {
+                        scratch[i] = grid.start + static_cast<double>(begin + i) * grid.step;
+                    }
+                    transformAxis(scratch, n, xTransform, scratch, xs);
+                }
+            } else {
+                transformAxis(dataX + begin, n, xTransform, scratch, xs);
+            }
+            transformAxis(dataY + begin, n, yTransform, scratch, ys);
+            fn(begin, xs, ys, n);
+        }
+    });
+}
+
+/**
+ * @brief M4 decimation of a uniform-x series whose points advance by
+ * pixelsPerPoint > 0 canvas units, which needs a linear x axis. Column
+ * boundaries follow from the grid,
+ * so each pixel column is indexed directly and only its y values are
+ * scanned; the kept points are the ones M4Decimator keeps.
+ */
+void decimateGrid(const DataSeries& series, size_t begin, size_t end, double pixelsPerPoint,
+                  const AxisTransform& xTransform, const AxisTransform& yTransform,
+                  SkPath& path) {
+    ColumnView grid = series.xColumn();
+    auto canvasX = [&](size_t i) {
+        float x;
+        transformGrid(grid.start, grid.step, i, 1, xTransform, &x);
+        return x;
+    };
+    
+    M4Decimator decimator(path);
+    visitColumns(series, [&](const auto*, const auto* ys, size_t) {
+        auto sample = [&](size_t i) {
+            double scratch;
+            M4Decimator::Sample s{i, canvasX(i), 0.0f};
+            transformAxis(ys + i, 1, yTransform, &scratch, &s.y);
+            return s;
+        };
+        
+        size_t first = begin;
+        while (first < end) {
+            float x = canvasX(first);
+            if (!std::isfinite(x)) {
+                decimator.gap();
+                ++first;
+                continue;
+            }
+            
+            // First point of the next column: estimate from the spacing, then
+            // step to the exact boundary of the rounded canvas coordinates
+            double column = std::floor(x);
+            double estimate = std::ceil((column + 1.0 - x) / pixelsPerPoint);
+            size_t next = first + static_cast<size_t>(
+                std::clamp(estimate, 1.0, static_cast<double>(end - first)));
+            while (next > first + 1 && std::floor(canvasX(next - 1)) > column) {
+                --next;
+            }
+            while (next < end && std::floor(canvasX(next)) <= column) {
+                ++next;
+            }
+            
+            // Data y extremes are the canvas y extremes, possibly swapped. A
+            // missing value splits the column, as in M4Decimator::add()
+            for (size_t start = first; start < next;) {
+                size_t stop = start;
+                size_t lo = start, hi = start;
+                for (; stop < next && std::isfinite(ys[stop]); ++stop) {
+                    if (ys[stop] < ys[lo]) lo = stop;
+                    if (ys[stop] > ys[hi]) hi = stop;
+                }
+                if (stop > start) {
+                    decimator.addColumn(sample(start), sample(stop - 1), sample(lo), sample(hi));
+                }
+                if (stop < next) {
+                    decimator.gap();
+                }
+                start = stop + 1;
+            }
+            first = next;
+        }
+    });
+    decimator.flush();
+}
+
+/**
+ * @brief M4 decimation through the series' min/max pyramid. The points of
+ * each pixel column are found by binary search and their y extremes by a
+ * pyramid query, so the cost is O(columns * log N) however many points
+ * there are. Points outside canvas columns [0, columns) are skipped,
+ * except the two the visible line connects to. A column the pyramid
+ * reports missing values in is scanned instead, so the line breaks at
+ * them exactly as in the M4Decimator scan.
+ */
+void decimatePyramid(const DataSeries& series, size_t begin, size_t end, int columns,
+                     const AxisTransform& xTransform, const AxisTransform& yTransform,
+                     SkPath& path) {
+    // Same arithmetic as transformAxis(), so columns match M4Decimator's.
+    // Axis scales are monotonic, so data y extremes stay canvas y extremes.
+    ColumnView xs = series.xColumn();
+    ColumnView ys = series.yColumn();
+    auto sample = [&](size_t i) {
+        return M4Decimator::Sample{i, static_cast<float>(xTransform.apply(xs[i])),
+                                   static_cast<float>(yTransform.apply(ys[i]))};
+    };
+    auto column = [&](size_t i) { return std::floor(sample(i).x); };
+    auto firstInColumn = [&](size_t from, size_t to, double c) {
+        while (from < to) {
+            size_t mid = from + (to - from) / 2;
+            if (column(mid) < c) {
+                from = mid + 1;
+            } else {
+                to = mid;
+            }
+        }
+        return from;
+    };
+    
+    M4Decimator decimator(path);
+    auto addPoint = [&](size_t i) {
+        M4Decimator::Sample s = sample(i);
+        decimator.addColumn(s, s, s, s);
+    };
+    
+    size_t first = firstInColumn(begin, end, 0.0);
+    size_t last = firstInColumn(first, end, static_cast<double>(columns));
+    if (first > begin) {
+        addPoint(first - 1);
+    }
+    for (size_t i = first; i < last;) {
+        size_t next = firstInColumn(i + 1, last, column(i) + 1.0);
+        size_t lo = i, hi = i, missing = 0;
+        series.findYExtremes(i, next, lo, hi, &missing);
+        if (missing == 0) {
+            decimator.addColumn(sample(i), sample(next - 1), sample(lo), sample(hi));
+        } else {
+            // Split the column at its missing values, as decimateGrid() does
+            for (size_t start = i; start < next;) {
+                size_t stop = start;
+                lo = hi = start;
+                for (; stop < next && std::isfinite(ys[stop]); ++stop) {
+                    if (ys[stop] < ys[lo]) lo = stop;
+                    if (ys[stop] > ys[hi]) hi = stop;
+                }
+                if (stop > start) {
+                    decimator.addColumn(sample(start), sample(stop - 1), sample(lo), sample(hi));
+                }
+                if (stop < next) {
+                    decimator.gap();
+                }
+                start = stop + 1;
+            }
+        }
+        i = next;
+    }
+    if (last < end) {
+        addPoint(last);
+    }
+    decimator.flush();
+}
+
+/**
+ * @brief Marks the points of pts[first..last] that Douglas-Peucker keeps:
+ * the farthest point from the chord is kept while it lies more than the
+ * tolerance away, then both halves are refined.
+ */
+void douglasPeucker(const SkPoint* pts, size_t first, size_t last, double toleranceSq,
+                    std::vector<uint8_t>& keep) {
+    keep[first] = keep[last] = 1;
+    
+    // Explicit stack: series paths can have millions of points
+    std::vector<std::pair<size_t, size_t>> spans{{first, last}};
+    while (!spans.empty()) {
+        auto [a, b] = spans.back();
+        spans.pop_back();
+        if (b <= a + 1) {
+            continue;
+        }
+        
+        double ax = pts[a].fX, ay = pts[a].fY;
+        double dx = pts[b].fX - ax, dy = pts[b].fY - ay;
+        double lengthSq = dx * dx + dy * dy;
+        
+        double farthestSq = -1.0;
+        size_t farthest = a;
+        for (size_t i = a + 1; i < b; ++i) {
+            // Distance to the segment, not the line: polylines fold back on
+            // themselves within a pixel column
+            double px = pts[i].fX - ax, py = pts[i].fY - ay;
+            double t = lengthSq > 0.0 ? std::clamp((px * dx + py * dy) / lengthSq, 0.0, 1.0) : 0.0;
+            double ex = px - t * dx, ey = py - t * dy;
+            double distSq = ex * ex + ey * ey;
+            if (distSq > farthestSq) {
+                farthestSq = distSq;
+                farthest = i;
+            }
+        }
+        
+        if (farthestSq > toleranceSq) {
+            keep[farthest] = 1;
+            spans.push_back({a, farthest});
+            spans.push_back({farthest, b});
+        }
+    }
+}
+
+/**
+ * @brief Simplifies a series polyline (contours of one moveTo followed by
+ * lineTos) so no point moves more than tolerance canvas units. Each contour
+ * keeps its end points, so gaps stay where they are.
+ */
+void simplifyPath(SkPath& path, float tolerance) {
+    int count = path.countPoints();
+    if (tolerance <= 0.0f || count < 3 || path.countVerbs() != count) {
+        return;
+    }
+    
+    std::vector<SkPoint> pts(count);
+    path.getPoints(pts.data(), count);
+    std::vector<uint8_t> verbs(count);
+    path.getVerbs(verbs.data(), count);
+    
+    std::vector<uint8_t> keep(count, 0);
+    double toleranceSq = static_cast<double>(tolerance) * tolerance;
+    size_t contourStart = 0;
+    for (size_t i = 1; i <= pts.size(); ++i) {
+        if (i == pts.size() || verbs[i] == SkPath::kMove_Verb) {
+            douglasPeucker(pts.data(), contourStart, i - 1, toleranceSq, keep);
+            contourStart = i;
+        }
+    }
+    
+    SkPath simplified;
+    for (size_t i = 0; i < pts.size(); ++i) {
+        if (!keep[i]) {
+            continue;
+        }
+        if (verbs[i] == SkPath::kMove_Verb) {
+            simplified.moveTo(pts[i].fX, pts[i].fY);
+        } else {
+            simplified.lineTo(pts[i].fX, pts[i].fY);
+        }
+    }
+    simplified.updateBoundsCache();
+    path = std::move(simplified);
+}
+
+/**
+ * @brief Index of the first point with x >= value in an x-sorted series.
+ */
+size_t lowerBoundX(const DataSeries& series, double value) {
+    if (series.isUniformX()) {
+        // Computed from the grid, then corrected for rounding
+        ColumnView grid = series.xColumn();
+        if (!(grid.step > 0.0)) {
+            return grid.size > 0 && grid.start < value ? grid.size : 0;
+        }
+        double estimate = std::ceil((value - grid.start) / grid.step);
+        size_t index = estimate > 0.0 ? static_cast<size_t>(
+            std::min(estimate, static_cast<double>(grid.size))) : 0;
+        while (index > 0 && grid[index - 1] >= value) {
+            --index;
+        }
+        while (index < grid.size && grid[index] < value) {
+            ++index;
+        }
+        return index;
+    }
+    
+    size_t index = 0;
+    visitColumns(series, [&](const auto* xs, const auto*, size_t count) {
+        index = std::lower_bound(xs, xs + count, value) - xs;
+    });
+    return index;
+}
+
+// Line colors, cycled per series
+constexpr uint32_t kSeriesColors[] = {
+    0xFF0000FF,  // Blue
+    0xFFFF0000,  // Red
+    0xFF00AA00,  // Green
+    0xFFFF8800,  // Orange
+    0xFF8800FF,  // Purple
+};
+
+uint32_t seriesColor(size_t index) {
+    return kSeriesColors[index % (sizeof(kSeriesColors) / sizeof(kSeriesColors[0]))];
+}
+
+} // namespace
+
+// ============================================================================
+// Min/Max Pyramid
+// ============================================================================
+
+namespace {
+
+// Blocks of one level merged into a block of the next
+constexpr size_t kPyramidFanout = 8;
+constexpr size_t kMaxPyramidLevels = 24;
+
+// Layout of files written by DataSeries::savePyramid(), little-endian:
+// magic, version, flags, block size, fanout and level count (uint32 each),
+// point count and data fingerprint (uint64 each), then per level its first
+// block number and block count (uint64 each) followed by the blocks
+constexpr char kPyramidFileMagic[4] = {'S', 'K', 'P', 'M'};
+constexpr uint32_t kPyramidFileVersion = 3;
+constexpr size_t kPyramidFileHeaderSize = 40;
+constexpr size_t kPyramidFileBlockSize = 40;
+constexpr uint32_t kPyramidFileSortedX = 1;
+
+} // namespace
+
+/**
+ * @brief Level-of-detail index of the y extremes of a series.
+ *
+ * Level 0 keeps the y min/max, the point numbers (see
+ * DataSeries::getRemovedCount) holding them and the number of missing
+ * (non-finite) y of every block of blockSize points; each further level
+ * merges kPyramidFanout blocks of the one below. Blocks are aligned to point numbers and only complete blocks are
+ * stored, so appends add blocks at the end and front removals only make
+ * leading blocks unused. A query covers its range with the largest stored
+ * blocks that fit and scans less than a block of points at either end.
+ */
+class MinMaxPyramid {
+public:
+    struct Block {
+        double min;
+        double max;
+        uint64_t minPoint;
+        uint64_t maxPoint;
+        uint64_t missing;
+    };
+    
+    struct Level {
+        uint64_t base = 0;  // Block number of blocks[0]
+        std::vector<Block> blocks;
+    };
+    
+    explicit MinMaxPyramid(size_t blockSize) : blockSize_(std::max<size_t>(blockSize, 2)) {}
+    
+    static Block emptyBlock() {
+        return {INFINITY, -INFINITY, UINT64_MAX, UINT64_MAX, 0};
+    }
+    
+    // Block of the single point p with y value v
+    static Block pointBlock(double v, uint64_t p) {
+        return {v, v, p, p, std::isfinite(v) ? 0u : 1u};
+    }
+    
+    // Merges b into a; a holds earlier points, so it wins ties
+    static void merge(Block& a, const Block& b) {
+        a.missing += b.missing;
+        if (b.min < a.min) {
+            a.min = b.min;
+            a.minPoint = b.minPoint;
+        }
+        if (b.max > a.max) {
+            a.max = b.max;
+            a.maxPoint = b.maxPoint;
+        }
+    }
+    
+    size_t blockSize() const { return blockSize_; }
+    const std::vector<Level>& levels() const { return levels_; }
+    
+    uint64_t span(size_t level) const {
+        uint64_t span = blockSize_;
+        for (size_t i = 0; i < level; ++i) {
+            span *= kPyramidFanout;
+        }
+        return span;
+    }
+    
+    bool isCurrent(const DataSeries& series) const {
+        return revision_ == series.getRevision() && removed_ == series.getRemovedCount() &&
+               end_ == series.getRemovedCount() + series.size();
+    }
+    
+    // Adopts levels read from a file, built over the same points
+    void assign(std::vector<Level> levels, const DataSeries& series) {
+        levels_ = std::move(levels);
+        revision_ = series.getRevision();
+        removed_ = end_ = 0;
+    }
+    
+    void update(const DataSeries& series) {
+        if (revision_ != series.getRevision()) {
+            levels_.clear();
+            revision_ = series.getRevision();
+        }
+        removed_ = series.getRemovedCount();
+        end_ = removed_ + series.size();
+        
+        if (series.getValueType() == ValueType::Float64) {
+            updateLevels(series.yColumn().asFloat64());
+        } else {
+            updateLevels(series.yColumn().asFloat32());
+        }
+    }
+    
+    // Extremes over the points with indices [begin, end) of a current pyramid
+    Block find(const DataSeries& series, size_t begin, size_t end) const {
+        if (series.getValueType() == ValueType::Float64) {
+            return findIn(series.yColumn().asFloat64(), begin, end);
+        }
+        return findIn(series.yColumn().asFloat32(), begin, end);
+    }
+
+private:
+    template <typename T>
+    void updateLevels(const T* ys) {
+        for (size_t k = 0; k < kMaxPyramidLevels; ++k) {
+            if (k == levels_.size()) {
+                // A new level once the one below can fill one of its blocks
+                if (k > 0 && levels_[k - 1].blocks.size() < kPyramidFanout) {
+                    break;
+                }
+                levels_.emplace_back();
+            }
+            
+            // Blocks whose points or child blocks are all available
+            Level& level = levels_[k];
+            uint64_t firstBlock, endBlock;
+            if (k == 0) {
+                firstBlock = (removed_ + blockSize_ - 1) / blockSize_;
+                endBlock = end_ / blockSize_;
+            } else {
+                const Level& below = levels_[k - 1];
+                firstBlock = (below.base + kPyramidFanout - 1) / kPyramidFanout;
+                endBlock = (below.base + below.blocks.size()) / kPyramidFanout;
+            }
+            
+            if (level.base + level.blocks.size() < firstBlock) {
+                level.blocks.clear();
+                level.base = firstBlock;
+            } else if (firstBlock > level.base &&
+                       firstBlock - level.base > level.blocks.size() / 2) {
+                // Drop unused leading blocks once they are the majority
+                level.blocks.erase(level.blocks.begin(),
+                                   level.blocks.begin() + (firstBlock - level.base));
+                level.base = firstBlock;
+            }
+            
+            for (uint64_t j = level.base + level.blocks.size(); j < endBlock; ++j) {
+                Block block = emptyBlock();
+                if (k == 0) {
+                    for (uint64_t p = j * blockSize_; p < (j + 1) * blockSize_; ++p) {
+                        double v = ys[p - removed_];
+                        if (v < block.min) {
+                            block.min = v;
+                            block.minPoint = p;
+                        }
+                        if (v > block.max) {
+                            block.max = v;
+                            block.maxPoint = p;
+                        }
+                        if (!std::isfinite(v)) {
+                            ++block.missing;
+                        }
+                    }
+                } else {
+                    const Level& below = levels_[k - 1];
+                    for (uint64_t c = j * kPyramidFanout; c < (j + 1) * kPyramidFanout; ++c) {
+                        merge(block, below.blocks[c - below.base]);
+                    }
+                }
+                level.blocks.push_back(block);
+            }
+        }
+    }
+    
+    template <typename T>
+    Block findIn(const T* ys, size_t begin, size_t end) const {
+        Block result = emptyBlock();
+        uint64_t p = removed_ + begin;
+        uint64_t last = removed_ + end;
+        while (p < last) {
+            // Largest stored block that starts here and fits
+            bool merged = false;
+            if (p % blockSize_ == 0) {
+                for (size_t k = levels_.size(); k-- > 0 && !merged;) {
+                    uint64_t span = this->span(k);
+                    const Level& level = levels_[k];
+                    uint64_t j = p / span;
+                    if (p % span == 0 && span <= last - p && j >= level.base &&
+                        j < level.base + level.blocks.size()) {
+                        merge(result, level.blocks[j - level.base]);
+                        p += span;
+                        merged = true;
+                    }
+                }
+            }
+            if (!merged) {
+                double v = ys[p - removed_];
+                merge(result, pointBlock(v, p));
+                ++p;
+            }
+        }
+        return result;
+    }
+    
+    size_t blockSize_;
+    std::vector<Level> levels_;
+    uint64_t revision_ = UINT64_MAX;
+    uint64_t removed_ = 0;
+    uint64_t end_ = 0;
+};
+
+// Blocks are written to and read from files as they are laid out in memory
+static_assert(sizeof(MinMaxPyramid::Block) == kPyramidFileBlockSize, "unexpected block padding");
+
+namespace {
+
+// Independent hash chains a pyramid file's fingerprint interleaves values
+// over, so the multiplies of neighbouring values overlap
+constexpr size_t kPyramidFingerprintLanes = 4;
+
+/**
+ * @brief Hashes the bits of each value into one of the lanes. Each step is
+ * a bijection of the lane state, so changing any single value always
+ * changes the result.
+ */
+template <typename T>
+void hashValues(const T* values, size_t count, uint64_t* lanes) {
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &values[i], sizeof(T));
+        uint64_t& lane = lanes[i % kPyramidFingerprintLanes];
+        lane = (lane ^ bits) * 0x100000001B3ull;
+        lane ^= lane >> 29;
+    }
+}
+
+/**
+ * @brief Hash of every stored x and y value among the first count points
+ * (the grid start and step of uniform x), so a pyramid file is only
+ * loaded into the data it was built from. One pass at about memory speed,
+ * several times cheaper than building the pyramid.
+ */
+uint64_t pyramidFingerprint(const DataSeries& series, uint64_t count) {
+    uint64_t lanes[kPyramidFingerprintLanes];
+    for (size_t k = 0; k < kPyramidFingerprintLanes; ++k) {
+        lanes[k] = 0xCBF29CE484222325ull + k;
+    }
+    ColumnView x = series.xColumn();
+    if (x.uniform) {
+        double grid[2] = {x.start, x.step};
+        hashValues(grid, 2, lanes);
+    }
+    visitColumns(series, [&](const auto* xs, const auto* ys, size_t) {
+        if (xs) {
+            hashValues(xs, static_cast<size_t>(count), lanes);
+        }
+        hashValues(ys, static_cast<size_t>(count), lanes);
+    });
+    
+    uint64_t hash = count;
+    for (uint64_t lane : lanes) {
+        hash = (hash ^ lane) * 0x100000001B3ull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+} // namespace
+
+const MinMaxPyramid& DataSeries::pyramid() const {
+    if (!pyramid_->isCurrent(*this)) {
+        // Copies share the pyramid until one of them changes
+        if (pyramid_.use_count() > 1) {
+            pyramid_ = std::make_shared<MinMaxPyramid>(*pyramid_);
+        }
+        pyramid_->update(*this);
+    }
+    return *pyramid_;
+}
+
+void DataSeries::buildPyramid(size_t blockSize) {
+    pyramid_ = std::make_shared<MinMaxPyramid>(blockSize);
+    pyramid();
+    isSortedByX();
+}
+
+bool DataSeries::findYExtremes(size_t begin, size_t end, size_t& minIndex, size_t& maxIndex,
+                               size_t* missing) const {
+    end = std::min(end, size());
+    if (missing) {
+        *missing = 0;
+    }
+    if (begin >= end) {
+        return false;
+    }
+    
+    // The pyramid reports point numbers, the scan indices
+    MinMaxPyramid::Block extremes = MinMaxPyramid::emptyBlock();
+    uint64_t first = 0;
+    if (pyramid_) {
+        extremes = pyramid().find(*this, begin, end);
+        first = removed_;
+    } else {
+        visitColumns(*this, [&](const auto*, const auto* ys, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                double v = ys[i];
+                MinMaxPyramid::merge(extremes, MinMaxPyramid::pointBlock(v, i));
+            }
+        });
+    }
+    
+    if (missing) {
+        *missing = static_cast<size_t>(extremes.missing);
+    }
+    if (extremes.minPoint == UINT64_MAX) {
+        return false;
+    }
+    minIndex = static_cast<size_t>(extremes.minPoint - first);
+    maxIndex = static_cast<size_t>(extremes.maxPoint - first);
+    return true;
+}
+
+void DataSeries::getYRange(double xFrom, double xTo, double& yMin, double& yMax) const {
+    yMin = yMax = std::numeric_limits<double>::quiet_NaN();
+    if (isSortedByX()) {
+        size_t begin = lowerBoundX(*this, xFrom);
+        size_t end = lowerBoundX(*this, std::nextafter(xTo, INFINITY));
+        size_t minIndex, maxIndex;
+        if (findYExtremes(begin, end, minIndex, maxIndex)) {
+            yMin = y(minIndex);
+            yMax = y(maxIndex);
+        }
+        return;
+    }
+    
+    ColumnView xs = xColumn();
+    ColumnView ys = yColumn();
+    for (size_t i = 0; i < size(); ++i) {
+        double v = ys[i];
+        if (xs[i] >= xFrom && xs[i] <= xTo && !std::isnan(v)) {
+            yMin = std::isnan(yMin) ? v : std::min(yMin, v);
+            yMax = std::isnan(yMax) ? v : std::max(yMax, v);
+        }
+    }
+}
+
+bool DataSeries::savePyramid(const std::string& path) const {
+    if (!pyramid_ || removed_ != 0 || !isLittleEndian()) {
+        return false;
+    }
+    
+    const MinMaxPyramid& index = pyramid();
+    const std::vector<MinMaxPyramid::Level>& levels = index.levels();
+    uint8_t header[kPyramidFileHeaderSize] = {};
+    std::memcpy(header, kPyramidFileMagic, sizeof(kPyramidFileMagic));
+    writeLE<uint32_t>(header + 4, kPyramidFileVersion);
+    writeLE<uint32_t>(header + 8, isSortedByX() ? kPyramidFileSortedX : 0);
+    writeLE<uint32_t>(header + 12, static_cast<uint32_t>(index.blockSize()));
+    writeLE<uint32_t>(header + 16, static_cast<uint32_t>(kPyramidFanout));
+    writeLE<uint32_t>(header + 20, static_cast<uint32_t>(levels.size()));
+    writeLE<uint64_t>(header + 24, size());
+    writeLE<uint64_t>(header + 32, pyramidFingerprint(*this, size()));
+    
+    SkFILEWStream stream(path.c_str());
+    if (!stream.isValid() || !stream.write(header, sizeof(header))) {
+        return false;
+    }
+    for (const MinMaxPyramid::Level& level : levels) {
+        uint8_t counts[16];
+        writeLE<uint64_t>(counts, level.base);
+        writeLE<uint64_t>(counts + 8, level.blocks.size());
+        if (!stream.write(counts, sizeof(counts)) ||
+            !stream.write(level.blocks.data(), level.blocks.size() * kPyramidFileBlockSize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DataSeries::loadPyramid(const std::string& path) {
+    std::shared_ptr<MappedFile> file = MappedFile::open(path);
+    if (!file || removed_ != 0 || !isLittleEndian() || file->size() < kPyramidFileHeaderSize) {
+        return false;
+    }
+    
+    const uint8_t* data = file->data();
+    uint64_t blockSize = readLE<uint32_t>(data + 12);
+    uint32_t levelCount = readLE<uint32_t>(data + 20);
+    uint64_t points = readLE<uint64_t>(data + 24);
+    if (std::memcmp(data, kPyramidFileMagic, sizeof(kPyramidFileMagic)) != 0 ||
+        readLE<uint32_t>(data + 4) != kPyramidFileVersion || blockSize < 2 ||
+        readLE<uint32_t>(data + 16) != kPyramidFanout || levelCount > kMaxPyramidLevels ||
+        points > size() || readLE<uint64_t>(data + 32) != pyramidFingerprint(*this, points)) {
+        return false;
+    }
+    
+    // Only accept blocks that lie within the indexed points
+    auto index = std::make_shared<MinMaxPyramid>(static_cast<size_t>(blockSize));
+    std::vector<MinMaxPyramid::Level> levels(levelCount);
+    uint64_t offset = kPyramidFileHeaderSize;
+    for (uint32_t k = 0; k < levelCount; ++k) {
+        if (file->size() - offset < 16) {
+            return false;
+        }
+        MinMaxPyramid::Level& level = levels[k];
+        level.base = readLE<uint64_t>(data + offset);
+        uint64_t count = readLE<uint64_t>(data + offset + 8);
+        offset += 16;
+        uint64_t span = index->span(k);
+        if (count > (file->size() - offset) / kPyramidFileBlockSize ||
+            level.base > points / span || count > points / span - level.base) {
+            return false;
+        }
+        
+        level.blocks.resize(static_cast<size_t>(count));
+        std::memcpy(level.blocks.data(), data + offset, count * kPyramidFileBlockSize);
+        offset += count * kPyramidFileBlockSize;
+        for (const MinMaxPyramid::Block& block : level.blocks) {
+            if ((block.minPoint >= points && block.minPoint != UINT64_MAX) ||
+                (block.maxPoint >= points && block.maxPoint != UINT64_MAX) ||
+                block.missing > span) {
+                return false;
+            }
+        }
+    }
+    
+    // The few top-level blocks must name points holding their extremes
+    if (!levels.empty()) {
+        for (const MinMaxPyramid::Block& block : levels.back().blocks) {
+            if (block.minPoint != UINT64_MAX &&
+                (y(static_cast<size_t>(block.minPoint)) != block.min ||
+                 y(static_cast<size_t>(block.maxPoint)) != block.max)) {
+                return false;
+            }
+        }
+    }
+    
+    index->assign(std::move(levels), *this);
+    pyramid_ = std::move(index);
+    
+    // The file records whether x was sorted, which spares the first check
+    sortedByX_ = (readLE<uint32_t>(data + 8) & kPyramidFileSortedX) != 0;
+    sortedCheckedTo_ = static_cast<size_t>(points);
+    return true;
+}
+
+// ============================================================================
+// ThreadPool Implementation
+// ============================================================================
+
+namespace {
+
+// Set while a thread runs pool tasks (workers, and the caller while it
+// helps), so nested parallelFor calls run inline instead of deadlocking.
+thread_local bool tInsidePool = false;
+
+} // namespace
+
+/**
+ * @brief Fixed-size worker pool for data-parallel rendering stages.
+ *
+ * parallelFor() blocks until every index has been processed; the calling
+ * thread works alongside the workers, so a pool of size N starts N - 1
+ * threads. Calls from different threads are serialized.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads) {
+        for (size_t i = 1; i < std::max<size_t>(threads, 1); ++i) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+    }
+    
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+    
+    size_t size() const { return workers_.size() + 1; }
+    
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+        if (count == 0) {
+            return;
+        }
+        if (workers_.empty() || count == 1 || tInsidePool) {
+            for (size_t i = 0; i < count; ++i) {
+                fn(i);
+            }
+            return;
+        }
+        
+        std::lock_guard<std::mutex> runLock(runMutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &fn;
+            jobSize_ = count;
+            next_ = 0;
+            busyWorkers_ = workers_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+        
+        tInsidePool = true;
+        runIndices(fn, count);
+        tInsidePool = false;
+        
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return busyWorkers_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    void runIndices(const std::function<void(size_t)>& fn, size_t count) {
+        for (size_t i = next_.fetch_add(1); i < count; i = next_.fetch_add(1)) {
+            fn(i);
+        }
+    }
+    
+    void workerLoop() {
+        tInsidePool = true;
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t)>* job;
+            size_t count;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                if (stopping_) {
+                    return;
+                }
+                seen = generation_;
+                job = job_;
+                count = jobSize_;
+            }
+            
+            runIndices(*job, count);
+            
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busyWorkers_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+    
+    std::vector<std::thread> workers_;
+    std::mutex runMutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(size_t)>* job_ = nullptr;
+    size_t jobSize_ = 0;
+    std::atomic<size_t> next_{0};
+    size_t busyWorkers_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+};
+
+namespace {
+
+size_t resolveThreadCount(int requested) {
+    if (requested > 0) {
+        return static_cast<size_t>(requested);
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs fn for every index, on the pool if there is one
+void parallelFor(ThreadPool* pool, size_t count, const std::function<void(size_t)>& fn) {
+    if (pool) {
+        pool->parallelFor(count, fn);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// CSV Import
+// ============================================================================
+
+namespace {
+
+// Smaller inputs are not worth splitting across threads
+constexpr size_t kMinCsvChunkBytes = 256 * 1024;
+
+// Chunks per parser thread, so uneven rows still balance
+constexpr size_t kCsvChunksPerThread = 4;
+
+// Finds the first data line at or after pos, without its line break, and
+// moves pos past it. Blank lines and '#' comments are skipped.
+bool nextCsvLine(const char*& pos, const char* end, const char*& lineBegin,
+                 const char*& lineEnd) {
+    while (pos < end) {
+        const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        lineBegin = pos;
+        lineEnd = newline ? newline : end;
+        pos = newline ? newline + 1 : end;
+        if (lineEnd > lineBegin && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        if (lineEnd > lineBegin && *lineBegin != '#') {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Calls fn(begin, end) for every data line in [pos, end)
+template <typename Fn>
+void forEachCsvLine(const char* pos, const char* end, Fn&& fn) {
+    const char* lineBegin;
+    const char* lineEnd;
+    while (nextCsvLine(pos, end, lineBegin, lineEnd)) {
+        fn(lineBegin, lineEnd);
+    }
+}
+
+bool isCsvPadding(char c) {
+    return c == ' ' || c == '\t' || c == '"';
+}
+
+// Calls fn(index, begin, end) for every field of a line, with surrounding
+// spaces and quotes trimmed
+template <typename Fn>
+void forEachCsvField(const char* begin, const char* end, char delimiter, Fn&& fn) {
+    for (int index = 0;; ++index) {
+        const char* found = static_cast<const char*>(std::memchr(begin, delimiter, end - begin));
+        const char* fieldEnd = found ? found : end;
+        const char* first = begin;
+        const char* last = fieldEnd;
+        while (first < last && isCsvPadding(*first)) ++first;
+        while (last > first && isCsvPadding(last[-1])) --last;
+        fn(index, first, last);
+        if (!found) {
+            return;
+        }
+        begin = found + 1;
+    }
+}
+
+template <typename T>
+T parseCsvValue(const char* begin, const char* end) {
+    if (begin < end && *begin == '+') {
+        ++begin;
+    }
+    T value;
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    if (result.ec != std::errc() || result.ptr != end) {
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+    return value;
+}
+
+// pos if a line starts there, else the start of the next line, so chunk
+// boundaries never split a line; pos must not be the start of the text
+const char* nextLineStart(const char* pos, const char* end) {
+    const char* newline = static_cast<const char*>(std::memchr(pos - 1, '\n', end - (pos - 1)));
+    return newline ? newline + 1 : end;
+}
+
+/**
+ * @brief Owner of the columns behind one CSV series: the x column shared
+ * by every series of the file and the series' own y column.
+ */
+template <typename T>
+struct CsvSeriesColumns {
+    std::shared_ptr<const std::vector<T>> x;
+    std::vector<T> y;
+};
+
+template <typename T>
+bool parseCsvColumns(const char* text, size_t size, const CsvOptions& options,
+                     std::vector<DataSeries>& series) {
+    const char* end = text + size;
+    if (size >= 3 && std::memcmp(text, "\xEF\xBB\xBF", 3) == 0) {
+        text += 3;  // UTF-8 byte order mark
+    }
+    
+    // The first line fixes the delimiter, the column count and the names
+    const char* body = text;
+    const char* firstBegin;
+    const char* firstEnd;
+    if (!nextCsvLine(body, end, firstBegin, firstEnd)) {
+        return false;
+    }
+    if (!options.header) {
+        body = firstBegin;
+    }
+    
+    char delimiter = options.delimiter;
+    if (delimiter == 0) {
+        delimiter = std::memchr(firstBegin, '\t', firstEnd - firstBegin) ? '\t' : ',';
+    }
+    
+    std::vector<std::string> names;
+    forEachCsvField(firstBegin, firstEnd, delimiter, [&](int, const char* first, const char* last) {
+        names.emplace_back(first, last);
+    });
+    int numFields = static_cast<int>(names.size());
+    
+    // Output columns: x (unless x is the row number), then the y columns
+    std::vector<int> yColumns = options.yColumns;
+    if (yColumns.empty()) {
+        for (int i = 0; i < numFields; ++i) {
+            if (i != options.xColumn) {
+                yColumns.push_back(i);
+            }
+        }
+    }
+    bool hasX = options.xColumn >= 0;
+    if (options.xColumn >= numFields || options.xColumn < -1 || yColumns.empty()) {
+        return false;
+    }
+    std::vector<int> fields;
+    if (hasX) {
+        fields.push_back(options.xColumn);
+    }
+    for (int column : yColumns) {
+        if (column < 0 || column >= numFields) {
+            return false;
+        }
+        fields.push_back(column);
+    }
+    
+    // Output slots of each field, so a line is scanned once
+    int lastField = *std::max_element(fields.begin(), fields.end());
+    std::vector<std::vector<size_t>> slots(lastField + 1);
+    for (size_t slot = 0; slot < fields.size(); ++slot) {
+        slots[fields[slot]].push_back(slot);
+    }
+    
+    // Split the body at line starts
+    size_t threads = resolveThreadCount(options.threads);
+    size_t bodySize = static_cast<size_t>(end - body);
+    size_t numChunks = std::max<size_t>(1, std::min(threads * kCsvChunksPerThread,
+                                                    bodySize / kMinCsvChunkBytes));
+    std::vector<const char*> bounds(numChunks + 1, end);
+    bounds[0] = body;
+    for (size_t i = 1; i < numChunks; ++i) {
+        const char* pos = body + bodySize * i / numChunks;
+        bounds[i] = std::max(bounds[i - 1], nextLineStart(pos, end));
+    }
+    
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1 && numChunks > 1) {
+        pool = std::make_unique<ThreadPool>(std::min(threads, numChunks));
+    }
+    
+    // Count the rows of every chunk, then give each chunk its slice
+    std::vector<size_t> firstRow(numChunks + 1, 0);
+    parallelFor(pool.get(), numChunks, [&](size_t chunk) {
+        size_t rows = 0;
+        forEachCsvLine(bounds[chunk], bounds[chunk + 1], [&](const char*, const char*) { ++rows; });
+        firstRow[chunk + 1] = rows;
+    });
+    for (size_t i = 0; i < numChunks; ++i) {
+        firstRow[i + 1] += firstRow[i];
+    }
+    
+    std::vector<std::vector<T>> columns(fields.size());
+    for (auto& column : columns) {
+        column.resize(firstRow[numChunks]);
+    }
+    
+    parallelFor(pool.get(), numChunks, [&](size_t chunk) {
+        std::vector<T*> out(columns.size());
+        for (size_t slot = 0; slot < columns.size(); ++slot) {
+            out[slot] = columns[slot].data() + firstRow[chunk];
+        }
+        
+        T missing = std::numeric_limits<T>::quiet_NaN();
+        forEachCsvLine(bounds[chunk], bounds[chunk + 1], [&](const char* lineBegin,
+                                                             const char* lineEnd) {
+            int seen = 0;
+            forEachCsvField(lineBegin, lineEnd, delimiter, [&](int index, const char* first,
+                                                              const char* last) {
+                seen = index + 1;
+                if (index > lastField) {
+                    return;
+                }
+                for (size_t slot : slots[index]) {
+                    *out[slot] = parseCsvValue<T>(first, last);
+                }
+            });
+            
+            // Short rows leave the remaining columns empty
+            for (int index = seen; index <= lastField; ++index) {
+                for (size_t slot : slots[index]) {
+                    *out[slot] = missing;
+                }
+            }
+            for (T*& next : out) {
+                ++next;
+            }
+        });
+    });
+    
+    // A lone series owns its columns; several view one shared x column,
+    // each kept alive together with the series' y by the view's owner
+    series.clear();
+    series.reserve(yColumns.size());
+    size_t firstY = hasX ? 1 : 0;
+    std::shared_ptr<const std::vector<T>> x;
+    if (hasX && yColumns.size() > 1) {
+        x = std::make_shared<const std::vector<T>>(std::move(columns[0]));
+    }
+    for (size_t i = 0; i < yColumns.size(); ++i) {
+        std::string name = options.header ? names[yColumns[i]]
+                                          : "column " + std::to_string(yColumns[i]);
+        series.emplace_back(name, std::is_same<T, float>::value ? ValueType::Float32
+                                                                : ValueType::Float64);
+        std::vector<T>& y = columns[firstY + i];
+        if (!hasX) {
+            series.back().setUniformData(0.0, 1.0, std::move(y));
+        } else if (!x) {
+            series.back().setData(std::move(columns[0]), std::move(y));
+        } else {
+            auto owned = std::make_shared<CsvSeriesColumns<T>>(CsvSeriesColumns<T>{x, std::move(y)});
+            series.back().setView(Span<T>(*owned->x), Span<T>(owned->y), owned);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool parseCsv(const char* text, size_t size, std::vector<DataSeries>& series,
+              const CsvOptions& options) {
+    if (!text) {
+        return false;
+    }
+    if (options.type == ValueType::Float32) {
+        return parseCsvColumns<float>(text, size, options, series);
+    }
+    return parseCsvColumns<double>(text, size, options, series);
+}
+
+bool readCsvFile(const std::string& path, std::vector<DataSeries>& series,
+                 const CsvOptions& options) {
+    std::shared_ptr<MappedFile> file = MappedFile::open(path);
+    if (!file || file->size() == 0) {
+        return false;
+    }
+    return parseCsv(reinterpret_cast<const char*>(file->data()), file->size(), series, options);
+}
+
+// ============================================================================
+// Render Resources
+// ============================================================================
+
+/**
+ * @brief Immutable drawing state shared by every plot that renders with it.
+ *
+ * Fonts resolve their typeface on first use, so sharing one set avoids that
+ * lookup per chart. Instances are read-only once built and safe to use from
+ * several threads.
+ */
+struct RenderResources {
+    SkFont tickFont;
+    SkFont labelFont;
+    SkFont titleFont;
+    
+    RenderResources() {
+        tickFont.setSize(12);
+        labelFont.setSize(14);
+        titleFont.setSize(18);
+    }
+};
+
+/**
+ * @brief The Skia surface and images a Plot or Figure keeps between
+ * renders, held here so the public header needs no Skia headers
+ */
+struct RasterState {
+    sk_sp<SkSurface> surface;
+    sk_sp<SkImage> density;      // Density heatmap of the current render
+    sk_sp<SkImage> staticLayer;  // Background, grid and axes
+    sk_sp<SkPicture> labelLayer; // Title and axis labels
+};
+
+/**
+ * @brief Scratch buffers one plot reuses from render to render.
+ *
+ * Cleared paths keep their point storage and histograms keep their
+ * capacity, so a steady stream of renders of similar size stops
+ * allocating after the first few frames.
+ */
+struct RenderArena {
+    std::vector<SkPath> paths;                      // One per series
+    SkPath columnPath;                              // Incremental repaints
+    std::vector<std::vector<uint32_t>> histograms;  // Density bins per task
+};
+
+// ============================================================================
+// Text Layout
+// ============================================================================
+
+namespace {
+
+// Ticks per axis, plus one label at the far end
+constexpr int kNumTicks = 5;
+
+// Longest fixed-point double with one decimal: sign, 309 digits, ".0"
+constexpr size_t kMaxNumberLength = 320;
+
+/**
+ * @brief Formats value with one decimal into buffer, like printf("%.1f")
+ * but without a stream or heap allocation. Returns the length.
+ */
+size_t formatTickValue(double value, char* buffer) {
+    std::to_chars_result result = std::to_chars(buffer, buffer + kMaxNumberLength, value,
+                                                std::chars_format::fixed, 1);
+    return result.ec == std::errc() ? static_cast<size_t>(result.ptr - buffer) : 0;
+}
+
+/**
+ * @brief Formats a tick of a log or symlog axis with three significant
+ * digits, like printf("%.3g"): "0.001", "100", "1e+06".
+ */
+size_t formatScaledTickValue(double value, char* buffer) {
+    std::to_chars_result result = std::to_chars(buffer, buffer + kMaxNumberLength, value,
+                                                std::chars_format::general, 3);
+    return result.ec == std::errc() ? static_cast<size_t>(result.ptr - buffer) : 0;
+}
+
+/**
+ * @brief Tick values of a nonlinear axis over [min, max].
+ *
+ * Log10 axes tick at powers of ten and SymLog axes at zero and at
+ * +-threshold * 10^k; when there are too many, every n-th is kept (counting
+ * from 10^0 or zero). Ranges holding fewer than two of them get kNumTicks
+ * even steps in scaled units instead.
+ */
+void scaledTickValues(const AxisTransform& axis, double min, double max,
+                      std::vector<double>& values) {
+    values.clear();
+    double lo = axis.forward(min);
+    double hi = axis.forward(max);
+    
+    // Candidates as (step index, value); index 0 is the anchor
+    std::vector<std::pair<int, double>> candidates;
+    auto inRange = [&](double value) {
+        double scaled = axis.forward(value);
+        double slack = (hi - lo) * 1e-9;
+        return scaled >= lo - slack && scaled <= hi + slack;
+    };
+    if (axis.mapping == AxisScale::Log10) {
+        int first = static_cast<int>(std::ceil(lo - 1e-9));
+        int last = static_cast<int>(std::floor(hi + 1e-9));
+        for (int k = first; k <= last; ++k) {
+            candidates.emplace_back(k, std::pow(10.0, k));
+        }
+    } else {
+        // Decades up to the larger end of the range, mirrored around zero
+        double reach = std::max(std::fabs(lo), std::fabs(hi));
+        int decades = 0;
+        while (decades < 330 && axis.forward(axis.threshold * std::pow(10.0, decades)) <= reach) {
+            ++decades;
+        }
+        for (int k = decades - 1; k >= 0; --k) {
+            double value = -axis.threshold * std::pow(10.0, k);
+            if (inRange(value)) candidates.emplace_back(-(k + 1), value);
+        }
+        if (inRange(0.0)) candidates.emplace_back(0, 0.0);
+        for (int k = 0; k < decades; ++k) {
+            double value = axis.threshold * std::pow(10.0, k);
+            if (inRange(value)) candidates.emplace_back(k + 1, value);
+        }
+    }
+    
+    if (candidates.size() >= 2) {
+        int step = static_cast<int>((candidates.size() + kNumTicks) / (kNumTicks + 1));
+        for (const auto& [index, value] : candidates) {
+            if (index % step == 0) values.push_back(value);
+        }
+        if (values.size() >= 2) {
+            return;
+        }
+        values.clear();
+    }
+    for (int i = 0; i <= kNumTicks; ++i) {
+        values.push_back(axis.inverse(lo + i * (hi - lo) / kNumTicks));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief A shaped line of text and its measured bounds
+ */
+struct TextLayout {
+    sk_sp<SkTextBlob> blob;  // Null for empty text
+    SkRect bounds = SkRect::MakeEmpty();
+};
+
+/**
+ * @brief A tick mark and its label
+ */
+struct AxisTick {
+    float position = 0.0f;  // Canvas coordinate along the axis
+    TextLayout label;
+};
+
+/**
+ * @brief Shaped text by string and font size, plus the layouts of the
+ * current render.
+ *
+ * prepare() runs serially before drawing and fills the per-render layouts,
+ * which the tiles then only read. Tick labels repeat across renders of the
+ * same range and across charts of a batch, so most of them are cache hits.
+ */
+class TextCache {
+public:
+    TextLayout layout(const char* text, size_t length, const SkFont& font) {
+        Key key{font.getSize(), std::string(text, length)};
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            return it->second;
+        }
+        if (entries_.size() >= kMaxEntries) {
+            entries_.clear();
+        }
+        
+        TextLayout layout;
+        if (length > 0) {
+            layout.blob = SkTextBlob::MakeFromText(text, length, font, SkTextEncoding::kUTF8);
+            font.measureText(text, length, SkTextEncoding::kUTF8, &layout.bounds);
+        }
+        entries_.emplace(std::move(key), layout);
+        return layout;
+    }
+    
+    TextLayout layout(const std::string& text, const SkFont& font) {
+        return layout(text.data(), text.size(), font);
+    }
+    
+    // Layouts of the current render
+    std::vector<AxisTick> xTicks;
+    std::vector<AxisTick> yTicks;
+    TextLayout title;
+    TextLayout xLabel;
+    TextLayout yLabel;
+
+private:
+    static constexpr size_t kMaxEntries = 1024;
+    
+    struct Key {
+        float size;
+        std::string text;
+        
+        bool operator<(const Key& other) const {
+            if (size != other.size) return size < other.size;
+            return text < other.text;
+        }
+    };
+    
+    std::map<Key, TextLayout> entries_;
+};
+
+// ============================================================================
+// Markers
+// ============================================================================
+
+namespace {
+
+// Larger markers are drawn one by one; there are few of them on a chart
+constexpr float kMaxSpriteRadius = 32.0f;
+
+// Marker positions snap to this fraction of a pixel
+constexpr int kSubpixelSteps = 4;
+
+// Points drawn per drawAtlas call
+constexpr size_t kMarkerBatch = 4096;
+
+// Below this many points the coverage grid costs more than it saves
+constexpr size_t kMinPointsToSkipCovered = 4096;
+
+// Per-thread buffers of drawMarkers()
+struct MarkerScratch {
+    std::vector<SkRSXform> xforms;
+    std::vector<SkRect> cells;
+    std::vector<uint16_t> covered;
+};
+
+thread_local MarkerScratch tMarkerScratch;
+
+static_assert((kSubpixelSteps & (kSubpixelSteps - 1)) == 0, "sub-pixel split uses a mask");
+
+/**
+ * @brief Where and how a batch of markers is stamped into the atlas batch.
+ */
+struct MarkerStamp {
+    SkRect bounds;        // Canvas area a marker can reach the clip from
+    int gridLeft;         // Coverage grid origin and row length, in pixels
+    int gridTop;
+    size_t gridWidth;
+    uint16_t* covered;    // One bit per sub-pixel position, or null
+    int cell;
+    int center;
+};
+
+/**
+ * @brief Adds the atlas transform and cell of every marker in a batch of
+ * canvas points, calling flush() whenever kMarkerBatch are pending.
+ *
+ * Compiled once per coverage mode, so the per-point loop has no test for
+ * it. Points are split into whole pixels and a sub-pixel variant with
+ * integer arithmetic; that is exact for anything inside the bounds.
+ */
+template <bool kSkipCovered, typename Flush>
+void stampMarkers(const MarkerStamp& stamp, const float* xs, const float* ys, size_t count,
+                  std::vector<SkRSXform>& xforms, std::vector<SkRect>& cells, Flush&& flush) {
+    const SkRect& bounds = stamp.bounds;
+    float cell = static_cast<float>(stamp.cell);
+    for (size_t i = 0; i < count; ++i) {
+        // Also rejects NaN
+        if (!(xs[i] >= bounds.fLeft && xs[i] <= bounds.fRight &&
+              ys[i] >= bounds.fTop && ys[i] <= bounds.fBottom)) {
+            continue;
+        }
+        
+        int sx = floorToInt(xs[i] * kSubpixelSteps + 0.5f);
+        int sy = floorToInt(ys[i] * kSubpixelSteps + 0.5f);
+        int qx = sx & (kSubpixelSteps - 1);
+        int qy = sy & (kSubpixelSteps - 1);
+        int px = (sx - qx) / kSubpixelSteps;
+        int py = (sy - qy) / kSubpixelSteps;
+        
+        if constexpr (kSkipCovered) {
+            uint16_t& mask = stamp.covered[static_cast<size_t>(py - stamp.gridTop) * stamp.gridWidth +
+                                           (px - stamp.gridLeft)];
+            uint16_t bit = static_cast<uint16_t>(1u << (qy * kSubpixelSteps + qx));
+            if (mask & bit) {
+                continue;
+            }
+            mask |= bit;
+        }
+        
+        xforms.push_back(SkRSXform::Make(1.0f, 0.0f, static_cast<float>(px - stamp.center),
+                                         static_cast<float>(py - stamp.center)));
+        cells.push_back(SkRect::MakeXYWH(qx * cell, qy * cell, cell, cell));
+        if (xforms.size() == kMarkerBatch) {
+            flush();
+        }
+    }
+}
+
+/**
+ * @brief Outline of a non-circular marker centered on the origin.
+ */
+SkPath markerPath(MarkerShape shape, float radius) {
+    SkPath path;
+    switch (shape) {
+        case MarkerShape::Square: {
+            float half = radius * 0.75f;
+            path.addRect(SkRect::MakeLTRB(-half, -half, half, half));
+            break;
+        }
+        case MarkerShape::Diamond:
+            path.moveTo(0, -radius);
+            path.lineTo(radius, 0);
+            path.lineTo(0, radius);
+            path.lineTo(-radius, 0);
+            path.close();
+            break;
+        case MarkerShape::Triangle:
+            path.moveTo(0, -radius);
+            path.lineTo(radius * 0.866f, radius * 0.5f);
+            path.lineTo(-radius * 0.866f, radius * 0.5f);
+            path.close();
+            break;
+        case MarkerShape::Cross: {
+            float arm = radius * 0.3f;
+            path.addRect(SkRect::MakeLTRB(-radius, -arm, radius, arm));
+            path.addRect(SkRect::MakeLTRB(-arm, -radius, arm, radius));
+            break;
+        }
+        case MarkerShape::Circle:
+            path.addCircle(0, 0, radius);
+            break;
+    }
+    return path;
+}
+
+void drawMarkerShape(SkCanvas* canvas, MarkerShape shape, float radius, float x, float y,
+                     const SkPaint& paint) {
+    if (shape == MarkerShape::Circle) {
+        canvas->drawCircle(x, y, radius, paint);
+        return;
+    }
+    canvas->save();
+    canvas->translate(x, y);
+    canvas->drawPath(markerPath(shape, radius), paint);
+    canvas->restore();
+}
+
+} // namespace
+
+/**
+ * @brief A marker pre-rasterized at every quarter-pixel offset.
+ *
+ * The atlas is a kSubpixelSteps x kSubpixelSteps grid of cells; cell
+ * (qx, qy) holds the marker centered at (center + qx / 4, center + qy / 4).
+ * Stamping a cell at an integer position reproduces the antialiased
+ * marker to within 1/8 pixel of where it was asked for.
+ */
+struct MarkerSprite {
+    sk_sp<SkImage> atlas;
+    int cell = 0;
+    int center = 0;
+};
+
+/**
+ * @brief Marker sprites by shape, radius and color.
+ *
+ * prepare() rasterizes missing sprites and must run before any parallel
+ * drawing; find() is then safe to call from several threads.
+ */
+class MarkerCache {
+public:
+    void prepare(MarkerShape shape, float radius, uint32_t color) {
+        if (radius <= 0.0f || radius > kMaxSpriteRadius) {
+            return;
+        }
+        Key key{shape, radius, color};
+        if (sprites_.count(key)) {
+            return;
+        }
+        if (sprites_.size() >= kMaxSprites) {
+            sprites_.clear();
+        }
+        
+        MarkerSprite sprite;
+        sprite.center = static_cast<int>(std::ceil(radius)) + 1;
+        sprite.cell = 2 * sprite.center + 2;
+        int size = sprite.cell * kSubpixelSteps;
+        sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(size, size);
+        if (!surface) {
+            return;
+        }
+        
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->clear(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        paint.setColor(color);
+        paint.setStyle(SkPaint::kFill_Style);
+        paint.setAntiAlias(true);
+        for (int qy = 0; qy < kSubpixelSteps; ++qy) {
+            for (int qx = 0; qx < kSubpixelSteps; ++qx) {
+                float x = qx * sprite.cell + sprite.center + static_cast<float>(qx) / kSubpixelSteps;
+                float y = qy * sprite.cell + sprite.center + static_cast<float>(qy) / kSubpixelSteps;
+                drawMarkerShape(canvas, shape, radius, x, y, paint);
+            }
+        }
+        
+        sprite.atlas = surface->makeImageSnapshot();
+        if (sprite.atlas) {
+            sprites_.emplace(key, std::move(sprite));
+        }
+    }
+    
+    const MarkerSprite* find(MarkerShape shape, float radius, uint32_t color) const {
+        auto it = sprites_.find(Key{shape, radius, color});
+        return it != sprites_.end() ? &it->second : nullptr;
+    }
+
+private:
+    static constexpr size_t kMaxSprites = 64;
+    
+    struct Key {
+        MarkerShape shape;
+        float radius;
+        uint32_t color;
+        
+        bool operator<(const Key& other) const {
+            if (shape != other.shape) return shape < other.shape;
+            if (radius != other.radius) return radius < other.radius;
+            return color < other.color;
+        }
+    };
+    
+    std::map<Key, MarkerSprite> sprites_;
+};
+
+// ============================================================================
+// Density Rendering
+// ============================================================================
+
+namespace {
+
+// Colormap control points at even steps from 0 to 1 (RGB)
+constexpr uint32_t kViridis[] = {
+    0x440154, 0x482878, 0x3B528B, 0x2C728E, 0x21918C, 0x28AE80, 0x5EC962, 0xADDC30, 0xFDE725,
+};
+constexpr uint32_t kMagma[] = {
+    0x000004, 0x1C1044, 0x4F127B, 0x812581, 0xB5367A, 0xE55064, 0xFB8761, 0xFEC287, 0xFCFDBF,
+};
+constexpr uint32_t kGrayscale[] = {
+    0xE0E0E0, 0x000000,
+};
+
+/**
+ * @brief 256 premultiplied colors interpolated along a colormap.
+ */
+std::vector<SkPMColor> colormapTable(Colormap colormap) {
+    const uint32_t* stops = kViridis;
+    size_t numStops = sizeof(kViridis) / sizeof(kViridis[0]);
+    if (colormap == Colormap::Magma) {
+        stops = kMagma;
+        numStops = sizeof(kMagma) / sizeof(kMagma[0]);
+    } else if (colormap == Colormap::Grayscale) {
+        stops = kGrayscale;
+        numStops = sizeof(kGrayscale) / sizeof(kGrayscale[0]);
+    }
+    
+    std::vector<SkPMColor> table(256);
+    for (int i = 0; i < 256; ++i) {
+        float position = i / 255.0f * (numStops - 1);
+        size_t stop = std::min(static_cast<size_t>(position), numStops - 2);
+        float t = position - stop;
+        auto channel = [&](int shift) {
+            float a = (stops[stop] >> shift) & 0xFF;
+            float b = (stops[stop + 1] >> shift) & 0xFF;
+            return static_cast<unsigned>(a + (b - a) * t + 0.5f);
+        };
+        table[i] = SkPreMultiplyARGB(0xFF, channel(16), channel(8), channel(0));
+    }
+    return table;
+}
+
+/**
+ * @brief Adds canvas points to a histogram of width x height cells whose
+ * first cell is the pixel at (left, top).
+ */
+void binPoints(const float* xs, const float* ys, size_t count, float left, float top,
+               uint32_t width, uint32_t height, uint32_t* histogram) {
+    for (size_t i = 0; i < count; ++i) {
+        float fx = xs[i] - left;
+        float fy = ys[i] - top;
+        // Also rejects NaN and keeps the integer conversion in range
+        if (!(fx >= 0.0f && fx < width && fy >= 0.0f && fy < height)) {
+            continue;
+        }
+        ++histogram[static_cast<uint32_t>(fy) * width + static_cast<uint32_t>(fx)];
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Image Encoding
+// ============================================================================
+
+namespace {
+
+ImageFormat resolveFormat(const std::string& filename, ImageFormat format) {
+    if (format != ImageFormat::Auto) {
+        return format;
+    }
+    
+    size_t dot = filename.find_last_of('.');
+    if (dot == std::string::npos) {
+        return ImageFormat::PNG;
+    }
+    std::string ext = filename.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    
+    if (ext == "jpg" || ext == "jpeg") return ImageFormat::JPEG;
+    if (ext == "webp") return ImageFormat::WebP;
+    if (ext == "rgba" || ext == "raw") return ImageFormat::RawRGBA;
+    if (ext == "svg") return ImageFormat::SVG;
+    if (ext == "pdf") return ImageFormat::PDF;
+    return ImageFormat::PNG;
+}
+
+bool isVectorFormat(ImageFormat format) {
+    return format == ImageFormat::SVG || format == ImageFormat::PDF;
+}
+
+void reportEncoded(const EncodeOptions& options, const std::string& name, ImageFormat format,
+                   size_t bytes, std::chrono::steady_clock::time_point start) {
+    if (!options.onEncoded) {
+        return;
+    }
+    EncodeStats stats;
+    stats.format = format;
+    stats.bytes = bytes;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    options.onEncoded(name, stats);
+}
+
+SkPngEncoder::FilterFlag toSkFilter(PngFilter filter) {
+    switch (filter) {
+        case PngFilter::None: return SkPngEncoder::FilterFlag::kNone;
+        case PngFilter::Sub: return SkPngEncoder::FilterFlag::kSub;
+        case PngFilter::Up: return SkPngEncoder::FilterFlag::kUp;
+        case PngFilter::Average: return SkPngEncoder::FilterFlag::kAvg;
+        case PngFilter::Paeth: return SkPngEncoder::FilterFlag::kPaeth;
+        case PngFilter::All: break;
+    }
+    return SkPngEncoder::FilterFlag::kAll;
+}
+
+/**
+ * @brief Adapts a WriteCallback to the SkWStream interface of the encoders.
+ */
+class CallbackWStream : public SkWStream {
+public:
+    explicit CallbackWStream(const WriteCallback& write) : write_(write) {}
+    
+    bool write(const void* buffer, size_t size) override {
+        if (!write_(buffer, size)) {
+            return false;
+        }
+        bytesWritten_ += size;
+        return true;
+    }
+    
+    size_t bytesWritten() const override { return bytesWritten_; }
+
+private:
+    const WriteCallback& write_;
+    size_t bytesWritten_ = 0;
+};
+
+bool writeRawRGBA(SkWStream* stream, const SkPixmap& pixels) {
+    // Convert one row at a time to keep the scratch buffer small
+    SkImageInfo rowInfo = SkImageInfo::Make(pixels.width(), 1, kRGBA_8888_SkColorType,
+                                            kUnpremul_SkAlphaType);
+    std::vector<uint8_t> row(rowInfo.minRowBytes());
+    for (int y = 0; y < pixels.height(); ++y) {
+        SkPixmap src(pixels.info().makeWH(pixels.width(), 1), pixels.addr(0, y),
+                     pixels.rowBytes());
+        SkPixmap dst(rowInfo, row.data(), row.size());
+        if (!src.readPixels(dst) || !stream->write(row.data(), row.size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Encodes pixels into a stream in the format chosen for filename,
+ * then reports the result through options.onEncoded.
+ */
+bool encodePixels(SkWStream* stream, const SkPixmap& pixels, const std::string& filename,
+                  const EncodeOptions& options) {
+    ImageFormat format = resolveFormat(filename, options.format);
+    size_t startBytes = stream->bytesWritten();
+    auto start = std::chrono::steady_clock::now();
+    
+    bool ok = false;
+    switch (format) {
+        case ImageFormat::JPEG: {
+            SkJpegEncoder::Options jpeg;
+            jpeg.fQuality = std::clamp(options.quality, 0, 100);
+            ok = SkJpegEncoder::Encode(stream, pixels, jpeg);
+            break;
+        }
+        case ImageFormat::WebP: {
+            SkWebpEncoder::Options webp;
+            webp.fCompression = options.webpLossless ? SkWebpEncoder::Compression::kLossless
+                                                     : SkWebpEncoder::Compression::kLossy;
+            webp.fQuality = static_cast<float>(std::clamp(options.quality, 0, 100));
+            ok = SkWebpEncoder::Encode(stream, pixels, webp);
+            break;
+        }
+        case ImageFormat::RawRGBA:
+            ok = writeRawRGBA(stream, pixels);
+            break;
+        case ImageFormat::SVG:
+        case ImageFormat::PDF:
+            // Vector formats are drawn, not encoded from pixels
+            break;
+        case ImageFormat::Auto:
+        case ImageFormat::PNG: {
+            SkPngEncoder::Options png;
+            png.fZLibLevel = std::clamp(options.pngZlibLevel, 0, 9);
+            png.fFilterFlags = toSkFilter(options.pngFilter);
+            ok = SkPngEncoder::Encode(stream, pixels, png);
+            break;
+        }
+    }
+    
+    if (ok) {
+        reportEncoded(options, filename, format, stream->bytesWritten() - startBytes, start);
+    }
+    return ok;
+}
+
+/**
+ * @brief Writes a file through a temporary beside it that replaces path only
+ * once write() succeeds, so a failed render or encode leaves an existing file
+ * untouched instead of truncated. The temporary is named after the process
+ * and a counter, so concurrent writes to one path do not share it.
+ */
+bool writeFileReplacing(const std::string& path, const std::function<bool(SkWStream*)>& write) {
+    static std::atomic<uint64_t> counter{0};
+#if defined(_WIN32)
+    unsigned long process = GetCurrentProcessId();
+#else
+    long process = static_cast<long>(getpid());
+#endif
+    std::string temp = path + "." + std::to_string(process) + "-" +
+                       std::to_string(counter.fetch_add(1)) + ".tmp";
+    bool ok = false;
+    {
+        SkFILEWStream stream(temp.c_str());
+        ok = stream.isValid() && write(&stream);
+    }
+    if (ok) {
+#if defined(_WIN32)
+        ok = MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        ok = std::rename(temp.c_str(), path.c_str()) == 0;
+#endif
+    }
+    if (!ok) {
+        std::remove(temp.c_str());
+    }
+    return ok;
+}
+
+} // namespace
+
+// ============================================================================
+// Render Instrumentation
+// ============================================================================
+
+/**
+ * @brief Stats of the current render, shared by the tile threads
+ */
+struct StatsRecorder {
+    std::mutex mutex;
+    RenderStats stats;
+    bool collectStats = false;
+    std::shared_ptr<TraceRecorder> trace;
+    
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats = RenderStats();
+    }
+    
+    void count(size_t RenderStats::*counter, size_t n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.*counter += n;
+    }
+};
+
+namespace {
+
+/**
+ * @brief Adds the lifetime of a scope to a stage of the recorder's stats
+ * and its trace. With no recorder it does not even read the clock.
+ */
+class StageTimer {
+public:
+    StageTimer(StatsRecorder* recorder, const char* name, double RenderStats::*stage)
+        : recorder_(recorder), name_(name), stage_(stage) {
+        if (recorder_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+    
+    ~StageTimer() {
+        if (!recorder_) {
+            return;
+        }
+        
+        auto end = std::chrono::steady_clock::now();
+        if (stage_) {
+            std::lock_guard<std::mutex> lock(recorder_->mutex);
+            recorder_->stats.*stage_ += std::chrono::duration<double>(end - start_).count();
+        }
+        if (recorder_->trace) {
+            recorder_->trace->record(name_, start_, end);
+        }
+    }
+    
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    StatsRecorder* recorder_;
+    const char* name_;
+    double RenderStats::*stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace
+
+TraceRecorder::TraceRecorder() : epoch_(Clock::now()) {}
+
+void TraceRecorder::record(const char* name, Clock::time_point start, Clock::time_point end) {
+    uint64_t id = std::hash<std::thread::id>()(std::this_thread::get_id());
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // Threads are numbered in order of appearance so the viewer shows
+    // stable, readable lanes
+    uint32_t thread = static_cast<uint32_t>(threads_.size());
+    for (const auto& known : threads_) {
+        if (known.first == id) {
+            thread = known.second;
+            break;
+        }
+    }
+    if (thread == threads_.size()) {
+        threads_.emplace_back(id, thread);
+    }
+    
+    Event event;
+    event.name = name;
+    event.start = std::chrono::duration<double, std::micro>(start - epoch_).count();
+    event.duration = std::chrono::duration<double, std::micro>(end - start).count();
+    event.thread = thread;
+    events_.push_back(event);
+}
+
+void TraceRecorder::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+}
+
+std::vector<TraceRecorder::Event> TraceRecorder::events() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_;
+}
+
+std::string TraceRecorder::toJson() const {
+    std::vector<Event> events = this->events();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const Event& event = events[i];
+        out << (i > 0 ? ",\n" : "\n") << "{\"name\":\"" << event.name
+            << "\",\"cat\":\"skiaplot\",\"ph\":\"X\",\"ts\":" << event.start
+            << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":" << event.thread << "}";
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+bool TraceRecorder::writeJson(const std::string& filename) const {
+    SkFILEWStream stream(filename.c_str());
+    if (!stream.isValid()) {
+        return false;
+    }
+    
+    std::string json = toJson();
+    return stream.write(json.data(), json.size());
+}
+
+// ============================================================================
+// Plot Implementation
+// ============================================================================
+
+bool operator==(const PlotConfig& a, const PlotConfig& b) {
+    return a.width == b.width && a.height == b.height &&
+           a.marginLeft == b.marginLeft && a.marginRight == b.marginRight &&
+           a.marginTop == b.marginTop && a.marginBottom == b.marginBottom &&
+           a.backgroundColor == b.backgroundColor && a.axisColor == b.axisColor &&
+           a.gridColor == b.gridColor && a.lineColor == b.lineColor &&
+           a.lineWidth == b.lineWidth && a.showGrid == b.showGrid &&
+           a.showPoints == b.showPoints && a.pointRadius == b.pointRadius &&
+           a.markerShape == b.markerShape && a.dedupeMarkers == b.dedupeMarkers &&
+           a.decimate == b.decimate && a.vectorTolerance == b.vectorTolerance &&
+           a.density == b.density && a.colormap == b.colormap &&
+           a.densityLogScale == b.densityLogScale &&
+           a.xMin == b.xMin && a.xMax == b.xMax && a.yMin == b.yMin && a.yMax == b.yMax &&
+           a.xScale == b.xScale && a.yScale == b.yScale &&
+           a.symlogThreshold == b.symlogThreshold &&
+           a.incrementalRender == b.incrementalRender &&
+           a.cacheStaticLayer == b.cacheStaticLayer &&
+           a.renderThreads == b.renderThreads && a.tileHeight == b.tileHeight &&
+           a.title == b.title && a.xLabel == b.xLabel && a.yLabel == b.yLabel;
+}
+
+Plot::Plot(int width, int height)
+    : raster_(std::make_unique<RasterState>()), xMin_(0.0), xMax_(1.0), yMin_(0.0), yMax_(1.0) {
+    config_.width = width;
+    config_.height = height;
+}
+
+Plot::~Plot() = default;
+
+void Plot::setConfig(const PlotConfig& config) {
+    // setupCanvas() reallocates the surface if the size changed
+    config_ = config;
+}
+
+void Plot::addSeries(const DataSeries& series) {
+    series_.push_back(std::make_shared<DataSeries>(series));
+}
+
+void Plot::addSeries(DataSeries&& series) {
+    series_.push_back(std::make_shared<DataSeries>(std::move(series)));
+}
+
+void Plot::addSeries(std::shared_ptr<DataSeries> series) {
+    if (series) {
+        series_.push_back(std::move(series));
+    }
+}
+
+void Plot::clearSeries() {
+    series_.clear();
+    // A new series may reuse a removed one's address
+    drawnSurface_ = nullptr;
+}
+
+void Plot::setStatsEnabled(bool enabled) {
+    if (!recorder_) {
+        if (!enabled) {
+            return;
+        }
+        recorder_ = std::make_unique<StatsRecorder>();
+    }
+    recorder_->collectStats = enabled;
+    if (!enabled && !recorder_->trace) {
+        recorder_.reset();
+    }
+}
+
+void Plot::setTraceRecorder(std::shared_ptr<TraceRecorder> recorder) {
+    if (!recorder_) {
+        if (!recorder) {
+            return;
+        }
+        recorder_ = std::make_unique<StatsRecorder>();
+    }
+    recorder_->trace = std::move(recorder);
+    if (!recorder_->collectStats && !recorder_->trace) {
+        recorder_.reset();
+    }
+}
+
+const RenderStats& Plot::getRenderStats() const {
+    static const RenderStats kEmpty;
+    return recorder_ ? recorder_->stats : kEmpty;
+}
+
+void Plot::setupCanvas() {
+    StageTimer timer(recorder_.get(), "setupCanvas", &RenderStats::setupCanvas);
+    if (!raster_->surface || raster_->surface->width() != config_.width || 
+        raster_->surface->height() != config_.height) {
+        raster_->surface = SkSurface::MakeRasterN32Premul(config_.width, config_.height);
+    }
+}
+
+namespace {
+
+/**
+ * @brief An AxisTransform that only carries the axis scale; origin, scale
+ * and offset are left for the caller.
+ */
+AxisTransform scaleOnly(AxisScale mapping, double symlogThreshold) {
+    AxisTransform axis;
+    axis.mapping = mapping;
+    axis.threshold = symlogThreshold > 0.0 ? symlogThreshold : 1.0;
+    return axis;
+}
+
+// Folds the range [min, max] of one series into the plot range
+void mergeRange(double min, double max, bool& any, double& plotMin, double& plotMax) {
+    if (!(min <= max)) {
+        return;
+    }
+    plotMin = any ? std::min(plotMin, min) : min;
+    plotMax = any ? std::max(plotMax, max) : max;
+    any = true;
+}
+
+// Widens [min, max] by 5% of its length as the axis shows it, or by half a
+// unit (a decade on log axes) when it is a single value
+void padRange(const AxisTransform& axis, double& min, double& max) {
+    double lo = axis.forward(min);
+    double hi = axis.forward(max);
+    double padding = (hi - lo) * 0.05;
+    if (padding == 0.0) padding = 0.5;
+    min = axis.inverse(lo - padding);
+    max = axis.inverse(hi + padding);
+}
+
+} // namespace
+
+void Plot::computeDataRange() {
+    StageTimer timer(recorder_.get(), "computeDataRange", &RenderStats::computeDataRange);
+    // Series ranges are cached, so this is cheap enough to redo every render
+    xMin_ = 0.0;
+    xMax_ = 1.0;
+    yMin_ = 0.0;
+    yMax_ = 1.0;
+    
+    bool xLog = config_.xScale == AxisScale::Log10;
+    bool yLog = config_.yScale == AxisScale::Log10;
+    bool anyX = false;
+    bool anyY = false;
+    for (const auto& series : series_) {
+        double sXMin, sXMax, sYMin, sYMax;
+        series->getRange(sXMin, sXMax, sYMin, sYMax);
+        
+        if (series->empty()) {
+            continue;
+        }
+        
+        // A log axis only spans positive values; the (cached) smallest
+        // positive value is needed only when the range reaches zero
+        if ((xLog && !(sXMin > 0.0)) || (yLog && !(sYMin > 0.0))) {
+            double xPositive, yPositive;
+            series->getMinPositive(xPositive, yPositive);
+            if (xLog && !(sXMin > 0.0)) sXMin = xPositive;
+            if (yLog && !(sYMin > 0.0)) sYMin = yPositive;
+        }
+        
+        mergeRange(sXMin, sXMax, anyX, xMin_, xMax_);
+        mergeRange(sYMin, sYMax, anyY, yMin_, yMax_);
+    }
+    
+    // Add some padding to the range
+    if (anyX) padRange(scaleOnly(config_.xScale, config_.symlogThreshold), xMin_, xMax_);
+    if (anyY) padRange(scaleOnly(config_.yScale, config_.symlogThreshold), yMin_, yMax_);
+    
+    // Fixed limits override the data range
+    xMin_ = config_.xMin.value_or(xMin_);
+    xMax_ = config_.xMax.value_or(xMax_);
+    yMin_ = config_.yMin.value_or(yMin_);
+    yMax_ = config_.yMax.value_or(yMax_);
+    
+    // Log axes need a positive lower limit; without one they show three
+    // decades below the upper limit
+    if (xLog && !(xMin_ > 0.0)) xMin_ = xMax_ > 0.0 ? xMax_ / 1000.0 : 1.0;
+    if (yLog && !(yMin_ > 0.0)) yMin_ = yMax_ > 0.0 ? yMax_ / 1000.0 : 1.0;
+    
+    // A single fixed limit can end up on the wrong side of the data
+    if (!(xMax_ > xMin_)) xMax_ = xLog ? xMin_ * 10.0 : xMin_ + 1.0;
+    if (!(yMax_ > yMin_)) yMax_ = yLog ? yMin_ * 10.0 : yMin_ + 1.0;
+}
+
+void Plot::updateTransforms() {
+    int plotWidth = config_.width - config_.marginLeft - config_.marginRight;
+    int plotHeight = config_.height - config_.marginTop - config_.marginBottom;
+    
+    xTransform_ = scaleOnly(config_.xScale, config_.symlogThreshold);
+    yTransform_ = scaleOnly(config_.yScale, config_.symlogThreshold);
+    
+    // Origin and scale are in scaled units, the identity on linear axes
+    xTransform_.origin = xTransform_.forward(xMin_);
+    xTransform_.scale = plotWidth / (xTransform_.forward(xMax_) - xTransform_.origin);
+    xTransform_.offset = config_.marginLeft;
+    
+    // Canvas y grows downwards
+    yTransform_.origin = yTransform_.forward(yMin_);
+    yTransform_.scale = -plotHeight / (yTransform_.forward(yMax_) - yTransform_.origin);
+    yTransform_.offset = config_.marginTop + plotHeight;
+}
+
+SkRect Plot::plotArea() const {
+    return SkRect::MakeLTRB(config_.marginLeft, config_.marginTop,
+                            config_.width - config_.marginRight,
+                            config_.height - config_.marginBottom);
+}
+
+void Plot::visibleRange(const DataSeries& series, size_t& begin, size_t& end) const {
+    begin = 0;
+    end = series.size();
+    if (!series.isSortedByX()) {
+        return;
+    }
+    
+    // Points inside the x limits, plus one on each side for the segments
+    // that cross the plot edges
+    begin = lowerBoundX(series, xMin_);
+    end = lowerBoundX(series, std::nextafter(xMax_, INFINITY));
+    begin = begin > 0 ? begin - 1 : 0;
+    end = std::min(end + 1, series.size());
+}
+
+void Plot::dataToCanvas(double x, double y, float& canvasX, float& canvasY) const {
+    canvasX = static_cast<float>(xTransform_.apply(x));
+    canvasY = static_cast<float>(yTransform_.apply(y));
+}
+
+void Plot::drawBackground(SkCanvas* canvas) {
+    StageTimer timer(recorder_.get(), "drawBackground", &RenderStats::drawBackground);
+    SkPaint paint;
+    paint.setColor(config_.backgroundColor);
+    canvas->drawRect(SkRect::MakeWH(config_.width, config_.height), paint);
+}
+
+void Plot::drawGrid(SkCanvas* canvas) {
+    StageTimer timer(recorder_.get(), "drawGrid", &RenderStats::drawGrid);
+    if (!config_.showGrid) {
+        return;
+    }
+    
+    SkPaint paint;
+    paint.setColor(config_.gridColor);
+    paint.setStrokeWidth(1.0f);
+    paint.setStyle(SkPaint::kStroke_Style);
+    
+    int plotWidth = config_.width - config_.marginLeft - config_.marginRight;
+    int plotHeight = config_.height - config_.marginTop - config_.marginBottom;
+    
+    // Vertical grid lines; log and symlog axes put them at the ticks
+    if (xTransform_.isLinear()) {
+        int numVerticalLines = 10;
+        for (int i = 0; i <= numVerticalLines; ++i) {
+            float x = config_.marginLeft + (i * plotWidth / numVerticalLines);
+            canvas->drawLine(x, config_.marginTop, 
+                            x, config_.height - config_.marginBottom, paint);
+        }
+    } else {
+        for (const AxisTick& tick : text_->xTicks) {
+            canvas->drawLine(tick.position, config_.marginTop,
+                             tick.position, config_.height - config_.marginBottom, paint);
+        }
+    }
+    
+    // Horizontal grid lines
+    if (yTransform_.isLinear()) {
+        int numHorizontalLines = 10;
+        for (int i = 0; i <= numHorizontalLines; ++i) {
+            float y = config_.marginTop + (i * plotHeight / numHorizontalLines);
+            canvas->drawLine(config_.marginLeft, y, 
+                            config_.width - config_.marginRight, y, paint);
+        }
+    } else {
+        for (const AxisTick& tick : text_->yTicks) {
+            canvas->drawLine(config_.marginLeft, tick.position,
+                             config_.width - config_.marginRight, tick.position, paint);
+        }
+    }
+}
+
+void Plot::drawAxes(SkCanvas* canvas) {
+    StageTimer timer(recorder_.get(), "drawAxes", &RenderStats::drawAxes);
+    SkPaint paint;
+    paint.setColor(config_.axisColor);
+    paint.setStrokeWidth(2.0f);
+    paint.setStyle(SkPaint::kStroke_Style);
+    
+    int plotWidth = config_.width - config_.marginLeft - config_.marginRight;
+    int plotHeight = config_.height - config_.marginTop - config_.marginBottom;
+    
+    // X axis
+    canvas->drawLine(config_.marginLeft, 
+                    config_.height - config_.marginBottom,
+                    config_.marginLeft + plotWidth,
+                    config_.height - config_.marginBottom, paint);
+    
+    // Y axis
+    canvas->drawLine(config_.marginLeft, config_.marginTop,
+                    config_.marginLeft, 
+                    config_.marginTop + plotHeight, paint);
+    
+    // Draw tick marks and labels, laid out by prepareText()
+    paint.setStyle(SkPaint::kFill_Style);
+    
+    // X axis ticks
+    for (const AxisTick& tick : text_->xTicks) {
+        float x = tick.position;
+        float y = config_.height - config_.marginBottom;
+        
+        // Tick mark
+        canvas->drawLine(x, y, x, y + 5, paint);
+        
+        // Label
+        const TextLayout& label = tick.label;
+        if (label.blob) {
+            canvas->drawTextBlob(label.blob.get(), x - label.bounds.width() / 2, y + 20, paint);
+        }
+    }
+    
+    // Y axis ticks
+    for (const AxisTick& tick : text_->yTicks) {
+        float x = config_.marginLeft;
+        float y = tick.position;
+        
+        // Tick mark
+        canvas->drawLine(x - 5, y, x, y, paint);
+        
+        // Label
+        const TextLayout& label = tick.label;
+        if (label.blob) {
+            canvas->drawTextBlob(label.blob.get(), x - label.bounds.width() - 10,
+                                 y + label.bounds.height() / 2, paint);
+        }
+    }
+}
+
+void Plot::buildSeriesPath(const DataSeries& series, SkPath& path, size_t begin,
+                           size_t end) const {
+    end = std::min(end, series.size());
+    if (begin >= end) {
+        return;
+    }
+    
+    // Decide on the whole series, so a partial path matches the full one
+    size_t plotWidth = std::max(config_.width - config_.marginLeft - config_.marginRight, 1);
+    bool decimate = config_.decimate && config_.lineWidth <= kMaxDecimatedLineWidth &&
+                    series.isSortedByX() &&
+                    series.size() > kMinPointsPerColumnToDecimate * plotWidth;
+    
+    double pixelsPerPoint = series.xColumn().step * xTransform_.scale;
+    if (decimate && series.hasPyramid()) {
+        decimatePyramid(series, begin, end, config_.width, xTransform_, yTransform_, path);
+    } else if (decimate && series.isUniformX() && xTransform_.isLinear() &&
+               pixelsPerPoint > 0.0) {
+        decimateGrid(series, begin, end, pixelsPerPoint, xTransform_, yTransform_, path);
+    } else if (decimate) {
+        // Path size is bounded by four points per pixel column
+        M4Decimator decimator(path);
+        forEachCanvasChunk(series, begin, end, xTransform_, yTransform_,
+                           [&](size_t first, const float* xs, const float* ys, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                decimator.add(first + i, xs[i], ys[i]);
+            }
+        });
+        decimator.flush();
+    } else {
+        // Every point is a vertex, except inside runs that stay beyond the
+        // plot area. A miter join reaches up to miter limit * lineWidth / 2
+        // past its vertex, 2 * lineWidth at Skia's default limit of 4.
+        float pad = 2.0f * config_.lineWidth + 1.0f;
+        ViewportCuller culler(path, plotArea().makeOutset(pad, pad));
+        path.incReserve(static_cast<int>(std::min<size_t>(end - begin, INT32_MAX)));
+        forEachCanvasChunk(series, begin, end, xTransform_, yTransform_,
+                           [&](size_t, const float* xs, const float* ys, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                culler.add(xs[i], ys[i]);
+            }
+        });
+        culler.flush();
+    }
+    
+    // Compute the lazily cached bounds now, so tiles can share the path
+    path.updateBoundsCache();
+}
+
+void Plot::drawSeries(SkCanvas* canvas, const DataSeries& series, const SkPath& path,
+                      uint32_t color, size_t begin, size_t end) {
+    if (begin >= std::min(end, series.size())) {
+        return;
+    }
+    
+    // Lines and markers stay inside the axes when fixed limits cut through
+    // the data or a log axis sends values at or below zero to its floor.
+    // Otherwise the padded data range keeps them there without a clip.
+    bool clip = config_.xMin || config_.xMax || config_.yMin || config_.yMax ||
+                config_.xScale == AxisScale::Log10 || config_.yScale == AxisScale::Log10;
+    canvas->save();
+    if (clip) {
+        canvas->clipRect(plotArea());
+    }
+    
+    SkPaint linePaint;
+    linePaint.setColor(color);
+    linePaint.setStrokeWidth(config_.lineWidth);
+    linePaint.setStyle(SkPaint::kStroke_Style);
+    linePaint.setAntiAlias(true);
+    
+    {
+        StageTimer timer(recorder_.get(), "drawSeries", &RenderStats::drawSeries);
+        canvas->drawPath(path, linePaint);
+    }
+    
+    // Draw points if enabled
+    if (config_.showPoints) {
+        StageTimer timer(recorder_.get(), "drawMarkers", &RenderStats::drawMarkers);
+        
+        // Raster targets stamp pre-rasterized sprites; vector output keeps
+        // real shapes
+        const MarkerSprite* sprite = nullptr;
+        if (!vectorTarget_ && markers_) {
+            sprite = markers_->find(config_.markerShape, config_.pointRadius, color);
+        }
+        if (sprite) {
+            drawMarkers(canvas, series, *sprite, color, begin, end);
+        } else {
+            SkPaint pointPaint;
+            pointPaint.setColor(color);
+            pointPaint.setStyle(SkPaint::kFill_Style);
+            pointPaint.setAntiAlias(true);
+            
+            forEachCanvasChunk(series, begin, end, xTransform_, yTransform_,
+                               [&](size_t, const float* xs, const float* ys, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    drawMarkerShape(canvas, config_.markerShape, config_.pointRadius, xs[i],
+                                    ys[i], pointPaint);
+                }
+            });
+            if (recorder_) {
+                recorder_->count(&RenderStats::markersDrawn, std::min(end, series.size()) - begin);
+            }
+        }
+    }
+    canvas->restore();
+}
+
+void Plot::drawMarkers(SkCanvas* canvas, const DataSeries& series, const MarkerSprite& sprite,
+                       uint32_t color, size_t begin, size_t end) {
+    // Markers that cannot reach the clip are dropped before batching
+    SkRect clip = canvas->getLocalClipBounds();
+    float reach = static_cast<float>(sprite.cell);
+    SkRect bounds = SkRect::MakeLTRB(clip.left() - reach, clip.top() - reach,
+                                     clip.right() + reach, clip.bottom() + reach);
+    if (bounds.isEmpty()) {
+        return;
+    }
+    
+    // With dedupeMarkers, dense opaque series stamp each quarter-pixel
+    // position once; a repeat would still darken the antialiased edge
+    bool skipCovered = config_.dedupeMarkers && (color >> 24) == 0xFF &&
+                       end - begin >= kMinPointsToSkipCovered;
+    int gridLeft = static_cast<int>(std::floor(bounds.left()));
+    int gridTop = static_cast<int>(std::floor(bounds.top()));
+    size_t gridWidth = static_cast<size_t>(static_cast<int>(std::ceil(bounds.right())) - gridLeft + 1);
+    size_t gridHeight = static_cast<size_t>(static_cast<int>(std::ceil(bounds.bottom())) - gridTop + 1);
+    
+    // Batches and the coverage grid live in the calling thread's scratch,
+    // so tiles and frames reuse them instead of reallocating
+    MarkerScratch& scratch = tMarkerScratch;
+    std::vector<uint16_t>& covered = scratch.covered;
+    covered.assign(skipCovered ? gridWidth * gridHeight : 0, 0);
+    
+    std::vector<SkRSXform>& xforms = scratch.xforms;
+    std::vector<SkRect>& cells = scratch.cells;
+    xforms.clear();
+    cells.clear();
+    xforms.reserve(kMarkerBatch);
+    cells.reserve(kMarkerBatch);
+    
+    SkPaint paint;
+    SkSamplingOptions sampling(SkFilterMode::kNearest);
+    size_t stamped = 0;
+    auto flush = [&]() {
+        if (!xforms.empty()) {
+            stamped += xforms.size();
+            canvas->drawAtlas(sprite.atlas.get(), xforms.data(), cells.data(), nullptr,
+                              static_cast<int>(xforms.size()), SkBlendMode::kSrcOver, sampling,
+                              nullptr, &paint);
+            xforms.clear();
+            cells.clear();
+        }
+    };
+    
+    // The coverage mode is picked once per series, not per point
+    MarkerStamp stamp{bounds, gridLeft, gridTop, gridWidth,
+                      skipCovered ? covered.data() : nullptr, sprite.cell, sprite.center};
+    auto stampAll = [&](auto skip) {
+        forEachCanvasChunk(series, begin, end, xTransform_, yTransform_,
+                           [&](size_t, const float* xs, const float* ys, size_t count) {
+            stampMarkers<decltype(skip)::value>(stamp, xs, ys, count, xforms, cells, flush);
+        });
+    };
+    if (skipCovered) {
+        stampAll(std::true_type());
+    } else {
+        stampAll(std::false_type());
+    }
+    flush();
+    
+    if (recorder_) {
+        recorder_->count(&RenderStats::markersDrawn, stamped);
+    }
+}
+
+void Plot::prepareMarkers() {
+    if (!config_.showPoints || config_.density) {
+        return;
+    }
+    if (!markers_) {
+        markers_ = std::make_unique<MarkerCache>();
+    }
+    for (size_t i = 0; i < series_.size(); ++i) {
+        markers_->prepare(config_.markerShape, config_.pointRadius, seriesColor(i));
+    }
+}
+
+void Plot::drawLabels(SkCanvas* canvas) {
+    StageTimer timer(recorder_.get(), "drawLabels", &RenderStats::drawLabels);
+    SkPaint paint;
+    paint.setColor(config_.axisColor);
+    
+    // Draw title
+    const TextLayout& title = text_->title;
+    if (title.blob) {
+        canvas->drawTextBlob(title.blob.get(), (config_.width - title.bounds.width()) / 2, 25,
+                             paint);
+    }
+    
+    // Draw X label
+    const TextLayout& xLabel = text_->xLabel;
+    if (xLabel.blob) {
+        canvas->drawTextBlob(xLabel.blob.get(), (config_.width - xLabel.bounds.width()) / 2,
+                             config_.height - 10, paint);
+    }
+    
+    // Draw Y label (rotated)
+    const TextLayout& yLabel = text_->yLabel;
+    if (yLabel.blob) {
+        canvas->save();
+        canvas->translate(15, config_.height / 2);
+        canvas->rotate(-90);
+        canvas->drawTextBlob(yLabel.blob.get(), -yLabel.bounds.width() / 2, 0, paint);
+        canvas->restore();
+    }
+}
+
+void Plot::layoutTicks(const AxisTransform& axis, double min, double max, int start,
+                       int length, std::vector<AxisTick>& ticks) {
+    char buffer[kMaxNumberLength];
+    ticks.clear();
+    
+    // Linear axes: kNumTicks even steps on whole pixels
+    if (axis.isLinear()) {
+        for (int i = 0; i <= kNumTicks; ++i) {
+            double value = min + i * (max - min) / kNumTicks;
+            AxisTick tick;
+            tick.position = static_cast<float>(start + i * length / kNumTicks);
+            tick.label = text_->layout(buffer, formatTickValue(value, buffer),
+                                       resources_->tickFont);
+            ticks.push_back(tick);
+        }
+        return;
+    }
+    
+    std::vector<double> values;
+    scaledTickValues(axis, min, max, values);
+    for (double value : values) {
+        AxisTick tick;
+        tick.position = static_cast<float>(axis.apply(value));
+        tick.label = text_->layout(buffer, formatScaledTickValue(value, buffer),
+                                   resources_->tickFont);
+        ticks.push_back(tick);
+    }
+}
+
+void Plot::prepareText() {
+    if (!text_) {
+        text_ = std::make_unique<TextCache>();
+    }
+    
+    int plotWidth = config_.width - config_.marginLeft - config_.marginRight;
+    int plotHeight = config_.height - config_.marginTop - config_.marginBottom;
+    layoutTicks(xTransform_, xMin_, xMax_, config_.marginLeft, plotWidth, text_->xTicks);
+    layoutTicks(yTransform_, yMin_, yMax_, config_.marginTop + plotHeight, -plotHeight,
+                text_->yTicks);
+    
+    text_->title = text_->layout(config_.title, resources_->titleFont);
+    text_->xLabel = text_->layout(config_.xLabel, resources_->labelFont);
+    text_->yLabel = text_->layout(config_.yLabel, resources_->labelFont);
+}
+
+void Plot::prepareStaticLayer() {
+    double range[4] = {xMin_, xMax_, yMin_, yMax_};
+    bool sameKey = layerKeyed_ && layerConfig_ == config_ &&
+                   std::equal(range, range + 4, layerRange_);
+    if (!sameKey) {
+        // A one-off render would only pay for the extra image, so the
+        // layer waits until the next render shows the key is stable
+        raster_->staticLayer.reset();
+        raster_->labelLayer.reset();
+        layerConfig_ = config_;
+        std::copy(range, range + 4, layerRange_);
+        layerKeyed_ = true;
+        return;
+    }
+    if (raster_->staticLayer || !config_.cacheStaticLayer) {
+        return;
+    }
+    
+    sk_sp<SkSurface> layer = SkSurface::MakeRasterN32Premul(config_.width, config_.height);
+    if (!layer) {
+        return;
+    }
+    drawBackground(layer->getCanvas());
+    drawGrid(layer->getCanvas());
+    drawAxes(layer->getCanvas());
+    
+    SkPictureRecorder recorder;
+    drawLabels(recorder.beginRecording(SkRect::MakeWH(config_.width, config_.height)));
+    raster_->labelLayer = recorder.finishRecordingAsPicture();
+    raster_->staticLayer = layer->makeImageSnapshot();
+}
+
+void Plot::drawStaticLayer(SkCanvas* canvas) {
+    // Vector output keeps real shapes and text
+    if (!raster_->staticLayer || vectorTarget_) {
+        drawBackground(canvas);
+        drawGrid(canvas);
+        drawAxes(canvas);
+        return;
+    }
+    
+    // Drawing each element source-over onto a transparent layer and the
+    // layer source-over onto the canvas gives the same pixels as drawing
+    // the elements directly
+    StageTimer timer(recorder_.get(), "drawStaticLayer", &RenderStats::drawBackground);
+    canvas->drawImage(raster_->staticLayer.get(), 0, 0);
+}
+
+void Plot::drawLabelLayer(SkCanvas* canvas) {
+    if (!raster_->labelLayer || vectorTarget_) {
+        drawLabels(canvas);
+        return;
+    }
+    
+    StageTimer timer(recorder_.get(), "drawLabelLayer", &RenderStats::drawLabels);
+    canvas->drawPicture(raster_->labelLayer.get());
+}
+
+void Plot::drawFrame(SkCanvas* canvas, const std::vector<SkPath>& paths) {
+    drawStaticLayer(canvas);
+    
+    if (config_.density) {
+        if (raster_->density) {
+            canvas->drawImage(raster_->density.get(), config_.marginLeft, config_.marginTop);
+        }
+    } else {
+        // Draw each series with different colors
+        for (size_t i = 0; i < series_.size(); ++i) {
+            size_t begin, end;
+            visibleRange(*series_[i], begin, end);
+            drawSeries(canvas, *series_[i], paths[i], seriesColor(i), begin, end);
+        }
+    }
+    
+    drawLabelLayer(canvas);
+}
+
+void Plot::buildDensityImage() {
+    StageTimer timer(recorder_.get(), "buildDensityImage", &RenderStats::buildPaths);
+    raster_->density.reset();
+    int plotWidth = config_.width - config_.marginLeft - config_.marginRight;
+    int plotHeight = config_.height - config_.marginTop - config_.marginBottom;
+    if (plotWidth <= 0 || plotHeight <= 0) {
+        return;
+    }
+    
+    // Each task bins its slice of every series into a private histogram,
+    // so the hot loop needs no atomics
+    ThreadPool* pool = threadPool();
+    size_t cells = static_cast<size_t>(plotWidth) * plotHeight;
+    size_t tasks = pool ? pool->size() : 1;
+    std::vector<std::vector<uint32_t>>& histograms = arena().histograms;
+    histograms.resize(tasks);
+    parallelFor(pool, tasks, [&](size_t task) {
+        std::vector<uint32_t>& histogram = histograms[task];
+        histogram.assign(cells, 0);
+        for (const auto& series : series_) {
+            size_t count = series->size();
+            forEachCanvasChunk(*series, count * task / tasks, count * (task + 1) / tasks,
+                               xTransform_, yTransform_,
+                               [&](size_t, const float* xs, const float* ys, size_t n) {
+                binPoints(xs, ys, n, static_cast<float>(config_.marginLeft),
+                          static_cast<float>(config_.marginTop), plotWidth, plotHeight,
+                          histogram.data());
+            });
+        }
+    });
+    
+    // Sum into the first histogram, one task per row
+    std::vector<uint32_t>& counts = histograms[0];
+    parallelFor(pool, tasks > 1 ? plotHeight : 0, [&](size_t row) {
+        uint32_t* dst = counts.data() + row * plotWidth;
+        for (size_t task = 1; task < tasks; ++task) {
+            const uint32_t* src = histograms[task].data() + row * plotWidth;
+            for (int x = 0; x < plotWidth; ++x) {
+                dst[x] += src[x];
+            }
+        }
+    });
+    
+    uint32_t maxCount = *std::max_element(counts.begin(), counts.end());
+    if (maxCount == 0) {
+        return;
+    }
+    
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(plotWidth, plotHeight);
+    SkPixmap pixels;
+    if (!surface || !surface->peekPixels(&pixels)) {
+        return;
+    }
+    
+    // Empty cells stay transparent so the grid shows through
+    std::vector<SkPMColor> table = colormapTable(config_.colormap);
+    double scale = config_.densityLogScale ? 255.0 / std::log1p(static_cast<double>(maxCount))
+                                           : 255.0 / maxCount;
+    parallelFor(pool, plotHeight, [&](size_t row) {
+        const uint32_t* src = counts.data() + row * plotWidth;
+        SkPMColor* dst = static_cast<SkPMColor*>(pixels.writable_addr(0, static_cast<int>(row)));
+        for (int x = 0; x < plotWidth; ++x) {
+            if (src[x] == 0) {
+                dst[x] = 0;
+                continue;
+            }
+            double level = config_.densityLogScale ? std::log1p(static_cast<double>(src[x]))
+                                                   : static_cast<double>(src[x]);
+            dst[x] = table[std::min(static_cast<int>(level * scale + 0.5), 255)];
+        }
+    });
+    
+    raster_->density = surface->makeImageSnapshot();
+}
+
+bool Plot::findDirtyColumns(int& left, int& right) const {
+    if (!config_.incrementalRender || config_.density || drawnSurface_ != raster_->surface.get() ||
+        config_ != drawnConfig_ || series_.size() != drawnSeries_.size() ||
+        xMin_ != drawnRange_[0] || xMax_ != drawnRange_[1] ||
+        yMin_ != drawnRange_[2] || yMax_ != drawnRange_[3]) {
+        return false;
+    }
+    
+    // Data x interval whose pixels changed, over all series
+    double dirtyMin = INFINITY;
+    double dirtyMax = -INFINITY;
+    auto markDirty = [&](double from, double to) {
+        dirtyMin = std::min(dirtyMin, std::min(from, to));
+        dirtyMax = std::max(dirtyMax, std::max(from, to));
+    };
+    
+    for (size_t i = 0; i < series_.size(); ++i) {
+        const DataSeries& series = *series_[i];
+        const DrawnSeries& drawn = drawnSeries_[i];
+        uint64_t removed = series.getRemovedCount();
+        uint64_t end = removed + series.size();
+        
+        // Only appends and front removals of x-sorted data map to a column
+        // range; any other edit changes the revision
+        if (&series != drawn.series || series.getRevision() != drawn.revision ||
+            !series.isSortedByX() || removed < drawn.removed || end < drawn.end) {
+            return false;
+        }
+        
+        if (removed > drawn.removed && drawn.end > drawn.removed) {
+            // Evicted points, up to the line into the new first point
+            markDirty(drawn.firstX, series.empty() ? drawn.lastX : series.x(0));
+        }
+        if (end > drawn.end) {
+            // Appended points, from the line out of the old last point
+            size_t firstNew = drawn.end > removed ? drawn.end - removed : 0;
+            double from = drawn.end > drawn.removed ? drawn.lastX : series.x(firstNew);
+            markDirty(from, series.x(series.size() - 1));
+        }
+    }
+    
+    if (!(dirtyMin <= dirtyMax)) {
+        // Nothing changed
+        left = right = 0;
+        return true;
+    }
+    
+    // Pad by the reach of miter joins, markers and antialiasing
+    double pad = std::ceil(2.0 * config_.lineWidth + config_.pointRadius) + 2.0;
+    double from = std::floor(xTransform_.apply(dirtyMin) - pad);
+    double to = std::ceil(xTransform_.apply(dirtyMax) + pad);
+    left = static_cast<int>(std::clamp(from, 0.0, static_cast<double>(config_.width)));
+    right = static_cast<int>(std::clamp(to, 0.0, static_cast<double>(config_.width)));
+    
+    // Past half the canvas a full render is about as cheap
+    return right - left <= config_.width / 2;
+}
+
+void Plot::renderColumns(SkCanvas* canvas, int left, int right) {
+    if (left >= right) {
+        return;
+    }
+    
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(left, 0, right, config_.height));
+    
+    drawStaticLayer(canvas);
+    
+    // Points whose geometry can reach into the columns, plus the neighbours
+    // their line segments connect to
+    double pad = std::ceil(2.0 * config_.lineWidth + config_.pointRadius) + 2.0;
+    double xFrom = xTransform_.invert(left - pad);
+    double xTo = xTransform_.invert(right + pad);
+    
+    for (size_t i = 0; i < series_.size(); ++i) {
+        const DataSeries& series = *series_[i];
+        size_t begin = lowerBoundX(series, xFrom);
+        size_t end = lowerBoundX(series, std::nextafter(xTo, INFINITY));
+        begin = begin > 2 ? begin - 2 : 0;
+        end = std::min(end + 2, series.size());
+        
+        SkPath& path = arena().columnPath;
+        path.rewind();
+        {
+            StageTimer timer(recorder_.get(), "buildSeriesPaths", &RenderStats::buildPaths);
+            buildSeriesPath(series, path, begin, end);
+        }
+        if (recorder_) {
+            recorder_->count(&RenderStats::pathVerbs, path.countVerbs());
+        }
+        drawSeries(canvas, series, path, seriesColor(i), begin, end);
+    }
+    
+    drawLabelLayer(canvas);
+    canvas->restore();
+}
+
+void Plot::rememberDrawnState() {
+    drawnSurface_ = raster_->surface.get();
+    drawnConfig_ = config_;
+    drawnRange_[0] = xMin_;
+    drawnRange_[1] = xMax_;
+    drawnRange_[2] = yMin_;
+    drawnRange_[3] = yMax_;
+    
+    drawnSeries_.clear();
+    for (const auto& series : series_) {
+        DrawnSeries drawn;
+        drawn.series = series.get();
+        drawn.revision = series->getRevision();
+        drawn.removed = series->getRemovedCount();
+        drawn.end = drawn.removed + series->size();
+        drawn.firstX = series->empty() ? 0.0 : series->x(0);
+        drawn.lastX = series->empty() ? 0.0 : series->x(series->size() - 1);
+        drawnSeries_.push_back(drawn);
+    }
+}
+
+void Plot::buildSeriesPaths(std::vector<SkPath>& paths, float tolerance) {
+    StageTimer timer(recorder_.get(), "buildSeriesPaths", &RenderStats::buildPaths);
+    
+    // One task per series; rewinding keeps the storage of reused paths
+    paths.resize(series_.size());
+    parallelFor(threadPool(), series_.size(), [&](size_t i) {
+        size_t begin, end;
+        visibleRange(*series_[i], begin, end);
+        paths[i].rewind();
+        buildSeriesPath(*series_[i], paths[i], begin, end);
+        simplifyPath(paths[i], tolerance);
+    });
+    
+    if (recorder_) {
+        size_t verbs = 0;
+        for (const SkPath& path : paths) {
+            verbs += path.countVerbs();
+        }
+        recorder_->count(&RenderStats::pathVerbs, verbs);
+    }
+}
+
+void Plot::countPointsIn() {
+    if (!recorder_) {
+        return;
+    }
+    
+    size_t points = 0;
+    for (const auto& series : series_) {
+        points += series->size();
+    }
+    recorder_->count(&RenderStats::pointsIn, points);
+}
+
+RenderArena& Plot::arena() {
+    if (!arena_) {
+        arena_ = std::make_unique<RenderArena>();
+    }
+    return *arena_;
+}
+
+ThreadPool* Plot::threadPool() {
+    size_t threads = resolveThreadCount(config_.renderThreads);
+    if (threads <= 1) {
+        return nullptr;
+    }
+    if (!pool_ || pool_->size() != threads) {
+        pool_ = std::make_unique<ThreadPool>(threads);
+    }
+    return pool_.get();
+}
+
+bool Plot::render() {
+    if (recorder_) {
+        recorder_->reset();
+    }
+    StageTimer timer(recorder_.get(), "render", &RenderStats::renderSeconds);
+    
+    setupCanvas();
+    if (!raster_->surface) {
+        return false;
+    }
+    
+    computeDataRange();
+    updateTransforms();
+    countPointsIn();
+    
+    if (!resources_) {
+        resources_ = std::make_shared<RenderResources>();
+    }
+    
+    SkCanvas* canvas = raster_->surface->getCanvas();
+    if (!canvas) {
+        return false;
+    }
+    
+    // Sprites, text and the static layer are shared by every tile, so they
+    // are prepared up front
+    prepareMarkers();
+    prepareText();
+    prepareStaticLayer();
+    
+    // Streaming updates: repaint only the columns touched since last time
+    int dirtyLeft, dirtyRight;
+    if (findDirtyColumns(dirtyLeft, dirtyRight)) {
+        renderColumns(canvas, dirtyLeft, dirtyRight);
+        rememberDrawnState();
+        return true;
+    }
+    
+    // Series geometry does not depend on the target, so it is built once
+    // and shared by every tile
+    std::vector<SkPath>& paths = arena().paths;
+    if (config_.density) {
+        buildDensityImage();
+    } else {
+        buildSeriesPaths(paths, 0.0f);
+    }
+    
+    // Bands write straight into the surface's pixels, so detach them from
+    // any snapshot taken by an earlier saveToFile first
+    SkPixmap pixels;
+    bool tiled = config_.tileHeight > 0 && config_.tileHeight < config_.height;
+    if (tiled) {
+        raster_->surface->notifyContentWillChange(SkSurface::kDiscard_ContentChangeMode);
+    }
+    if (!tiled || !raster_->surface->peekPixels(&pixels)) {
+        drawFrame(canvas, paths);
+        rememberDrawnState();
+        return true;
+    }
+    
+    // Each band gets its own raster surface over its rows of the main
+    // surface's pixels, so the bands need no compositing afterwards. The
+    // band layout depends only on tileHeight, never on the thread count.
+    size_t numTiles = (config_.height + config_.tileHeight - 1) / config_.tileHeight;
+    std::atomic<bool> ok{true};
+    parallelFor(threadPool(), numTiles, [&](size_t tile) {
+        int top = static_cast<int>(tile) * config_.tileHeight;
+        int height = std::min(config_.tileHeight, config_.height - top);
+        SkImageInfo info = pixels.info().makeWH(config_.width, height);
+        sk_sp<SkSurface> band = SkSurface::MakeRasterDirect(info, pixels.writable_addr(0, top),
+                                                            pixels.rowBytes());
+        if (!band) {
+            ok = false;
+            return;
+        }
+        
+        SkCanvas* bandCanvas = band->getCanvas();
+        bandCanvas->translate(0, static_cast<float>(-top));
+        drawFrame(bandCanvas, paths);
+    });
+    
+    if (ok) {
+        rememberDrawnState();
+    } else {
+        drawnSurface_ = nullptr;
+    }
+    return ok;
+}
+
+bool Plot::saveToFile(const std::string& filename) {
+    return saveToFile(filename, EncodeOptions());
+}
+
+bool Plot::saveToFile(const std::string& filename, const EncodeOptions& options) {
+    return writeFileReplacing(filename, [&](SkWStream* stream) {
+        return writeImage(stream, filename, options);
+    });
+}
+
+bool Plot::saveToStream(SkWStream& stream, const EncodeOptions& options) {
+    return writeImage(&stream, std::string(), options);
+}
+
+bool Plot::saveToCallback(const WriteCallback& write, const EncodeOptions& options) {
+    if (!write) {
+        return false;
+    }
+    
+    CallbackWStream stream(write);
+    return writeImage(&stream, std::string(), options);
+}
+
+bool Plot::writeImage(SkWStream* stream, const std::string& name, const EncodeOptions& options) {
+    StageTimer timer(recorder_.get(), "save", nullptr);
+    ImageFormat format = resolveFormat(name, options.format);
+    if (isVectorFormat(format)) {
+        return writeVector(stream, name, format, options);
+    }
+    
+    if (!render()) {
+        return false;
+    }
+    
+    // Encode straight from the surface pixels, without a snapshot copy
+    SkPixmap pixels;
+    if (!raster_->surface->peekPixels(&pixels)) {
+        return false;
+    }
+    
+    size_t startBytes = stream->bytesWritten();
+    bool ok;
+    {
+        StageTimer encodeTimer(recorder_.get(), "encode", &RenderStats::encode);
+        ok = encodePixels(stream, pixels, name, options);
+        stream->flush();
+    }
+    if (ok && recorder_) {
+        recorder_->count(&RenderStats::bytesEncoded, stream->bytesWritten() - startBytes);
+    }
+    return ok;
 }
 
-void DataSeries::setPoints(const std::vector<Point>& points) {
-    points_ = points;
+bool Plot::writeVector(SkWStream* stream, const std::string& name, ImageFormat format,
+                       const EncodeOptions& options) {
+    size_t startBytes = stream->bytesWritten();
+    auto start = std::chrono::steady_clock::now();
+    
+    if (recorder_) {
+        recorder_->reset();
+    }
+    StageTimer timer(recorder_.get(), "encode", &RenderStats::encode);
+    
+    computeDataRange();
+    updateTransforms();
+    countPointsIn();
+    if (!resources_) {
+        resources_ = std::make_shared<RenderResources>();
+    }
+    prepareText();
+    
+    // Vector output keeps every path vertex, so thin the lines to what the
+    // page resolution can show
+    std::vector<SkPath> paths;
+    if (config_.density) {
+        buildDensityImage();
+    } else {
+        buildSeriesPaths(paths, config_.vectorTolerance);
+    }
+    
+    SkRect bounds = SkRect::MakeWH(config_.width, config_.height);
+    bool ok = false;
+    vectorTarget_ = true;
+    if (format == ImageFormat::SVG) {
+        std::unique_ptr<SkCanvas> canvas = SkSVGCanvas::Make(bounds, stream);
+        if (canvas) {
+            drawFrame(canvas.get(), paths);
+            // The SVG document is finished when its canvas is destroyed
+            canvas.reset();
+            ok = true;
+        }
+    } else {
+        sk_sp<SkDocument> document = SkPDF::MakeDocument(stream);
+        SkCanvas* canvas = document ? document->beginPage(bounds.width(), bounds.height())
+                                    : nullptr;
+        if (canvas) {
+            drawFrame(canvas, paths);
+            document->endPage();
+            document->close();
+            ok = true;
+        } else if (document) {
+            document->abort();
+        }
+    }
+    vectorTarget_ = false;
+    if (!ok) {
+        return false;
+    }
+    
+    stream->flush();
+    if (recorder_) {
+        recorder_->count(&RenderStats::bytesEncoded, stream->bytesWritten() - startBytes);
+    }
+    reportEncoded(options, name, format, stream->bytesWritten() - startBytes, start);
+    return true;
 }
 
-void DataSeries::getRange(double& xMin, double& xMax, double& yMin, double& yMax) const {
-    if (points_.empty()) {
-        xMin = xMax = yMin = yMax = 0.0;
-        return;
+bool Plot::renderTo(void* pixels, size_t rowBytes) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(config_.width, config_.height);
+    sk_sp<SkSurface> target = SkSurface::MakeRasterDirect(info, pixels, rowBytes);
+    if (!target) {
+        return false;
     }
     
-    xMin = xMax = points_[0].x;
-    yMin = yMax = points_[0].y;
+    // Draw through a wrapper surface over the caller's memory; the plot's
+    // own surface is kept for later renders
+    sk_sp<SkSurface> own = std::move(raster_->surface);
+    raster_->surface = std::move(target);
+    bool ok = render();
+    raster_->surface = std::move(own);
     
-    for (const auto& p : points_) {
-        xMin = std::min(xMin, p.x);
-        xMax = std::max(xMax, p.x);
-        yMin = std::min(yMin, p.y);
-        yMax = std::max(yMax, p.y);
-    }
+    // The buffer may change behind our back, so nothing carries over
+    drawnSurface_ = nullptr;
+    return ok;
+}
+
+SkCanvas* Plot::getCanvas() {
+    // The caller may draw anything, so the next render starts over
+    drawnSurface_ = nullptr;
+    setupCanvas();
+    return raster_->surface ? raster_->surface->getCanvas() : nullptr;
 }
 
 // ============================================================================
-// Plot Implementation
+// PlotBatch Implementation
 // ============================================================================
 
-Plot::Plot(int width, int height)
-    : xMin_(0.0), xMax_(1.0), yMin_(0.0), yMax_(1.0), rangeComputed_(false) {
-    config_.width = width;
-    config_.height = height;
-}
+/**
+ * @brief Keeps idle raster surfaces keyed by size for reuse across charts.
+ *
+ * At most maxIdle surfaces are retained in total; extra ones are freed.
+ */
+class SurfacePool {
+public:
+    explicit SurfacePool(size_t maxIdle) : maxIdle_(maxIdle) {}
+    
+    sk_sp<SkSurface> acquire(int width, int height) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = idle_.find({width, height});
+            if (it != idle_.end() && !it->second.empty()) {
+                sk_sp<SkSurface> surface = std::move(it->second.back());
+                it->second.pop_back();
+                --idleCount_;
+                return surface;
+            }
+        }
+        return SkSurface::MakeRasterN32Premul(width, height);
+    }
+    
+    void release(sk_sp<SkSurface> surface) {
+        if (!surface) {
+            return;
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idleCount_ < maxIdle_) {
+            idle_[{surface->width(), surface->height()}].push_back(std::move(surface));
+            ++idleCount_;
+        }
+    }
 
-Plot::~Plot() = default;
+private:
+    std::mutex mutex_;
+    std::map<std::pair<int, int>, std::vector<sk_sp<SkSurface>>> idle_;
+    size_t idleCount_ = 0;
+    size_t maxIdle_;
+};
 
-void Plot::setConfig(const PlotConfig& config) {
-    config_ = config;
-    surface_.reset();  // Force recreation with new size
-}
+/**
+ * @brief Per-thread render state of a PlotBatch
+ */
+struct BatchSlot {
+    Plot plot;
+};
 
-void Plot::addSeries(const DataSeries& series) {
-    series_.push_back(series);
-    rangeComputed_ = false;
+PlotBatch::PlotBatch(int threads, size_t maxQueuedJobs)
+    : maxQueuedJobs_(std::max<size_t>(maxQueuedJobs, 1)),
+      resources_(std::make_shared<RenderResources>()) {
+    size_t numThreads = resolveThreadCount(threads);
+    if (numThreads > 1) {
+        pool_ = std::make_unique<ThreadPool>(numThreads);
+    }
+    for (size_t i = 0; i < numThreads; ++i) {
+        slots_.push_back(std::make_unique<BatchSlot>());
+    }
+    surfaces_ = std::make_unique<SurfacePool>(2 * numThreads);
+    queue_.reserve(maxQueuedJobs_);
 }
 
-void Plot::clearSeries() {
-    series_.clear();
-    rangeComputed_ = false;
+PlotBatch::~PlotBatch() {
+    flush();
 }
 
-void Plot::setupCanvas() {
-    if (!surface_ || surface_->width() != config_.width || 
-        surface_->height() != config_.height) {
-        surface_ = SkSurface::MakeRasterN32Premul(config_.width, config_.height);
+bool PlotBatch::submit(PlotJob job) {
+    queue_.push_back(std::move(job));
+    if (queue_.size() >= maxQueuedJobs_) {
+        return flush();
     }
+    return true;
 }
 
-void Plot::computeDataRange() {
-    if (rangeComputed_ || series_.empty()) {
-        return;
+bool PlotBatch::flush() {
+    if (queue_.empty()) {
+        return true;
     }
     
-    bool first = true;
-    for (const auto& series : series_) {
-        double sXMin, sXMax, sYMin, sYMax;
-        series.getRange(sXMin, sXMax, sYMin, sYMax);
-        
-        if (series.getPoints().empty()) {
-            continue;
+    auto start = std::chrono::steady_clock::now();
+    
+    // At most pool-size jobs run at once, so a free slot always exists
+    std::mutex slotMutex;
+    std::vector<BatchSlot*> freeSlots;
+    for (auto& slot : slots_) {
+        freeSlots.push_back(slot.get());
+    }
+    
+    std::atomic<size_t> failed{0};
+    auto run = [&](size_t i) {
+        BatchSlot* slot;
+        {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            slot = freeSlots.back();
+            freeSlots.pop_back();
         }
         
-        if (first) {
-            xMin_ = sXMin;
-            xMax_ = sXMax;
-            yMin_ = sYMin;
-            yMax_ = sYMax;
-            first = false;
-        } else {
-            xMin_ = std::min(xMin_, sXMin);
-            xMax_ = std::max(xMax_, sXMax);
-            yMin_ = std::min(yMin_, sYMin);
-            yMax_ = std::max(yMax_, sYMax);
+        if (!renderJob(*slot, queue_[i])) {
+            ++failed;
         }
-    }
-    
-    // Add some padding to the range
-    double xPadding = (xMax_ - xMin_) * 0.05;
-    double yPadding = (yMax_ - yMin_) * 0.05;
+        
+        std::lock_guard<std::mutex> lock(slotMutex);
+        freeSlots.push_back(slot);
+    };
     
-    if (xPadding == 0.0) xPadding = 0.5;
-    if (yPadding == 0.0) yPadding = 0.5;
+    parallelFor(pool_.get(), queue_.size(), run);
     
-    xMin_ -= xPadding;
-    xMax_ += xPadding;
-    yMin_ -= yPadding;
-    yMax_ += yPadding;
+    stats_.chartsRendered += queue_.size() - failed;
+    stats_.chartsFailed += failed;
+    stats_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    queue_.clear();
     
-    rangeComputed_ = true;
+    return failed == 0;
 }
 
-void Plot::dataToCanvas(double x, double y, float& canvasX, float& canvasY) const {
-    int plotWidth = config_.width - config_.marginLeft - config_.marginRight;
-    int plotHeight = config_.height - config_.marginTop - config_.marginBottom;
-    
-    canvasX = config_.marginLeft + 
-              (x - xMin_) / (xMax_ - xMin_) * plotWidth;
-    canvasY = config_.marginTop + plotHeight - 
-              (y - yMin_) / (yMax_ - yMin_) * plotHeight;
+void Plot::loadJob(PlotJob& job, std::shared_ptr<const RenderResources> resources,
+                   SkSurface* surface) {
+    config_ = job.config;
+    config_.renderThreads = 1;  // Charts already run in parallel
+    series_.clear();
+    for (DataSeries& series : job.series) {
+        series_.push_back(std::make_shared<DataSeries>(std::move(series)));
+    }
+    drawnSurface_ = nullptr;  // Pooled surfaces hold other charts
+    resources_ = std::move(resources);
+    raster_->surface = sk_ref_sp(surface);
 }
 
-void Plot::drawBackground(SkCanvas* canvas) {
-    SkPaint paint;
-    paint.setColor(config_.backgroundColor);
-    canvas->drawRect(SkRect::MakeWH(config_.width, config_.height), paint);
+bool PlotBatch::renderJob(BatchSlot& slot, PlotJob& job) {
+    Plot& plot = slot.plot;
+    plot.loadJob(job, resources_,
+                 surfaces_->acquire(job.config.width, job.config.height).get());
+    
+    bool ok = writeFileReplacing(job.filename, [&](SkWStream* stream) {
+        return plot.writeImage(stream, job.filename, job.encode);
+    });
+    
+    surfaces_->release(std::move(plot.raster_->surface));
+    plot.series_.clear();
+    return ok;
 }
 
-void Plot::drawGrid(SkCanvas* canvas) {
-    if (!config_.showGrid) {
-        return;
-    }
-    
-    SkPaint paint;
-    paint.setColor(config_.gridColor);
-    paint.setStrokeWidth(1.0f);
-    paint.setStyle(SkPaint::kStroke_Style);
+// ============================================================================
+// PlotPipeline Implementation
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief FIFO between two pipeline stages; push() blocks while it is full.
+ *
+ * After close(), pop() drains what is left and then returns false.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
     
-    int plotWidth = config_.width - config_.marginLeft - config_.marginRight;
-    int plotHeight = config_.height - config_.marginTop - config_.marginBottom;
+    void push(T value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return items_.size() < capacity_; });
+        items_.push_back(std::move(value));
+        notEmpty_.notify_one();
+    }
     
-    // Vertical grid lines
-    int numVerticalLines = 10;
-    for (int i = 0; i <= numVerticalLines; ++i) {
-        float x = config_.marginLeft + (i * plotWidth / numVerticalLines);
-        canvas->drawLine(x, config_.marginTop, 
-                        x, config_.height - config_.marginBottom, paint);
+    bool pop(T& value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return false;
+        }
+        value = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
     }
     
-    // Horizontal grid lines
-    int numHorizontalLines = 10;
-    for (int i = 0; i <= numHorizontalLines; ++i) {
-        float y = config_.marginTop + (i * plotHeight / numHorizontalLines);
-        canvas->drawLine(config_.marginLeft, y, 
-                        config_.width - config_.marginRight, y, paint);
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
     }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+    std::deque<T> items_;
+    size_t capacity_;
+    bool closed_ = false;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 }
 
-void Plot::drawAxes(SkCanvas* canvas) {
-    SkPaint paint;
-    paint.setColor(config_.axisColor);
-    paint.setStrokeWidth(2.0f);
-    paint.setStyle(SkPaint::kStroke_Style);
+} // namespace
+
+/**
+ * @brief A job on its way through the pipeline stages
+ */
+struct PipelineItem {
+    PlotJob job;
+    sk_sp<SkSurface> surface;                        // Rendered pixels
+    std::unique_ptr<SkDynamicMemoryWStream> image;   // Encoded file contents
+    PipelineCallback done;
+    std::optional<std::promise<bool>> promise;
+};
+
+struct PipelineState {
+    using Queue = BoundedQueue<std::unique_ptr<PipelineItem>>;
     
-    int plotWidth = config_.width - config_.marginLeft - config_.marginRight;
-    int plotHeight = config_.height - config_.marginTop - config_.marginBottom;
+    explicit PipelineState(size_t depth, size_t maxIdleSurfaces)
+        : renderQueue(depth), encodeQueue(depth), writeQueue(depth),
+          surfaces(maxIdleSurfaces), resources(std::make_shared<RenderResources>()) {}
     
-    // X axis
-    canvas->drawLine(config_.marginLeft, 
-                    config_.height - config_.marginBottom,
-                    config_.marginLeft + plotWidth,
-                    config_.height - config_.marginBottom, paint);
+    Queue renderQueue;
+    Queue encodeQueue;
+    Queue writeQueue;
+    SurfacePool surfaces;
+    std::shared_ptr<const RenderResources> resources;
     
-    // Y axis
-    canvas->drawLine(config_.marginLeft, config_.marginTop,
-                    config_.marginLeft, 
-                    config_.marginTop + plotHeight, paint);
+    std::vector<std::thread> renderThreads;
+    std::vector<std::thread> encodeThreads;
+    std::thread writeThread;
     
-    // Draw tick marks and labels
-    SkFont font;
-    font.setSize(12);
-    paint.setStyle(SkPaint::kFill_Style);
+    mutable std::mutex mutex;
+    std::condition_variable idle;
+    size_t inFlight = 0;
+    PipelineStats stats;
+};
+
+PlotPipeline::PlotPipeline(const PipelineOptions& options) {
+    size_t renderThreads = resolveThreadCount(options.renderThreads);
+    size_t encodeThreads = resolveThreadCount(options.encodeThreads);
     
-    // X axis ticks
-    int numXTicks = 5;
-    for (int i = 0; i <= numXTicks; ++i) {
-        float x = config_.marginLeft + (i * plotWidth / numXTicks);
-        float y = config_.height - config_.marginBottom;
-        
-        // Tick mark
-        canvas->drawLine(x, y, x, y + 5, paint);
-        
-        // Label
-        double dataX = xMin_ + i * (xMax_ - xMin_) / numXTicks;
-        std::ostringstream oss;
-        oss << std::fixed << std::setprecision(1) << dataX;
-        std::string label = oss.str();
-        
-        SkRect bounds;
-        font.measureText(label.c_str(), label.length(), SkTextEncoding::kUTF8, &bounds);
-        canvas->drawSimpleText(label.c_str(), label.length(), SkTextEncoding::kUTF8,
-                              x - bounds.width() / 2, y + 20, font, paint);
+    // Surfaces are in use by render threads, waiting encodes and encoders
+    state_ = std::make_unique<PipelineState>(options.queueDepth,
+                                             renderThreads + options.queueDepth + encodeThreads);
+    for (size_t i = 0; i < renderThreads; ++i) {
+        state_->renderThreads.emplace_back([this] { renderLoop(); });
     }
-    
-    // Y axis ticks
-    int numYTicks = 5;
-    for (int i = 0; i <= numYTicks; ++i) {
-        float x = config_.marginLeft;
-        float y = config_.marginTop + plotHeight - (i * plotHeight / numYTicks);
-        
-        // Tick mark
-        canvas->drawLine(x - 5, y, x, y, paint);
-        
-        // Label
-        double dataY = yMin_ + i * (yMax_ - yMin_) / numYTicks;
-        std::ostringstream oss;
-        oss << std::fixed << std::setprecision(1) << dataY;
-        std::string label = oss.str();
-        
-        SkRect bounds;
-        font.measureText(label.c_str(), label.length(), SkTextEncoding::kUTF8, &bounds);
-        canvas->drawSimpleText(label.c_str(), label.length(), SkTextEncoding::kUTF8,
-                              x - bounds.width() - 10, y + bounds.height() / 2, font, paint);
+    for (size_t i = 0; i < encodeThreads; ++i) {
+        state_->encodeThreads.emplace_back([this] { encodeLoop(); });
     }
+    state_->writeThread = std::thread([this] { writeLoop(); });
 }
 
-void Plot::drawSeries(SkCanvas* canvas, const DataSeries& series, uint32_t color) {
-    const auto& points = series.getPoints();
-    if (points.empty()) {
-        return;
+PlotPipeline::~PlotPipeline() {
+    // Each stage drains its queue before the next one is closed
+    state_->renderQueue.close();
+    for (auto& thread : state_->renderThreads) {
+        thread.join();
     }
-    
-    SkPaint linePaint;
-    linePaint.setColor(color);
-    linePaint.setStrokeWidth(config_.lineWidth);
-    linePaint.setStyle(SkPaint::kStroke_Style);
-    linePaint.setAntiAlias(true);
-    
-    SkPath path;
-    float canvasX, canvasY;
-    
-    // Start path at first point
-    dataToCanvas(points[0].x, points[0].y, canvasX, canvasY);
-    path.moveTo(canvasX, canvasY);
-    
-    // Draw lines to subsequent points
-    for (size_t i = 1; i < points.size(); ++i) {
-        dataToCanvas(points[i].x, points[i].y, canvasX, canvasY);
-        path.lineTo(canvasX, canvasY);
+    state_->encodeQueue.close();
+    for (auto& thread : state_->encodeThreads) {
+        thread.join();
+    }
+    state_->writeQueue.close();
+    state_->writeThread.join();
+}
+
+std::future<bool> PlotPipeline::submit(PlotJob job) {
+    auto item = std::make_unique<PipelineItem>();
+    item->job = std::move(job);
+    item->promise.emplace();
+    std::future<bool> result = item->promise->get_future();
+    enqueue(std::move(item));
+    return result;
+}
+
+void PlotPipeline::submit(PlotJob job, PipelineCallback done) {
+    auto item = std::make_unique<PipelineItem>();
+    item->job = std::move(job);
+    item->done = std::move(done);
+    enqueue(std::move(item));
+}
+
+void PlotPipeline::enqueue(std::unique_ptr<PipelineItem> item) {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        ++state_->inFlight;
+    }
+    state_->renderQueue.push(std::move(item));
+}
+
+void PlotPipeline::wait() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->idle.wait(lock, [this] { return state_->inFlight == 0; });
+}
+
+PipelineStats PlotPipeline::getStats() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->stats;
+}
+
+void PlotPipeline::finish(PipelineItem& item, bool ok) {
+    state_->surfaces.release(std::move(item.surface));
+    if (item.done) {
+        item.done(item.job.filename, ok);
+    }
+    if (item.promise) {
+        item.promise->set_value(ok);
     }
     
-    canvas->drawPath(path, linePaint);
-    
-    // Draw points if enabled
-    if (config_.showPoints) {
-        SkPaint pointPaint;
-        pointPaint.setColor(color);
-        pointPaint.setStyle(SkPaint::kFill_Style);
-        pointPaint.setAntiAlias(true);
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    ++(ok ? state_->stats.chartsWritten : state_->stats.chartsFailed);
+    if (--state_->inFlight == 0) {
+        state_->idle.notify_all();
+    }
+}
+
+void PlotPipeline::renderLoop() {
+    // Each render thread keeps one plot, with its caches, for all its jobs
+    Plot plot;
+    std::unique_ptr<PipelineItem> item;
+    while (state_->renderQueue.pop(item)) {
+        auto start = std::chrono::steady_clock::now();
+        PlotJob& job = item->job;
+        ImageFormat format = resolveFormat(job.filename, job.encode.format);
+        bool vector = isVectorFormat(format);
+        
+        bool ok;
+        if (vector) {
+            plot.loadJob(job, state_->resources, nullptr);
+            item->image = std::make_unique<SkDynamicMemoryWStream>();
+            ok = plot.writeVector(item->image.get(), job.filename, format, job.encode);
+        } else {
+            plot.loadJob(job, state_->resources,
+                         state_->surfaces.acquire(job.config.width, job.config.height).get());
+            ok = plot.render();
+            item->surface = std::move(plot.raster_->surface);
+        }
+        plot.series_.clear();
         
-        for (const auto& point : points) {
-            dataToCanvas(point.x, point.y, canvasX, canvasY);
-            canvas->drawCircle(canvasX, canvasY, config_.pointRadius, pointPaint);
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->stats.renderSeconds += secondsSince(start);
+        }
+        if (!ok) {
+            finish(*item, false);
+        } else if (vector) {
+            state_->writeQueue.push(std::move(item));
+        } else {
+            state_->encodeQueue.push(std::move(item));
         }
     }
 }
 
-void Plot::drawLabels(SkCanvas* canvas) {
-    SkPaint paint;
-    paint.setColor(config_.axisColor);
-    
-    SkFont font;
-    
-    // Draw title
-    if (!config_.title.empty()) {
-        font.setSize(18);
-        SkRect bounds;
-        font.measureText(config_.title.c_str(), config_.title.length(), 
-                        SkTextEncoding::kUTF8, &bounds);
-        canvas->drawSimpleText(config_.title.c_str(), config_.title.length(), 
-                              SkTextEncoding::kUTF8,
-                              (config_.width - bounds.width()) / 2, 25, font, paint);
+void PlotPipeline::encodeLoop() {
+    std::unique_ptr<PipelineItem> item;
+    while (state_->encodeQueue.pop(item)) {
+        auto start = std::chrono::steady_clock::now();
+        SkPixmap pixels;
+        item->image = std::make_unique<SkDynamicMemoryWStream>();
+        bool ok = item->surface && item->surface->peekPixels(&pixels) &&
+                  encodePixels(item->image.get(), pixels, item->job.filename, item->job.encode);
+        
+        // The pixels are no longer needed, so the surface can serve the
+        // next render before the file is written
+        state_->surfaces.release(std::move(item->surface));
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->stats.encodeSeconds += secondsSince(start);
+        }
+        if (ok) {
+            state_->writeQueue.push(std::move(item));
+        } else {
+            finish(*item, false);
+        }
     }
-    
-    // Draw X label
-    if (!config_.xLabel.empty()) {
-        font.setSize(14);
-        SkRect bounds;
-        font.measureText(config_.xLabel.c_str(), config_.xLabel.length(), 
-                        SkTextEncoding::kUTF8, &bounds);
-        canvas->drawSimpleText(config_.xLabel.c_str(), config_.xLabel.length(), 
-                              SkTextEncoding::kUTF8,
-                              (config_.width - bounds.width()) / 2, 
-                              config_.height - 10, font, paint);
+}
+
+void PlotPipeline::writeLoop() {
+    std::unique_ptr<PipelineItem> item;
+    while (state_->writeQueue.pop(item)) {
+        auto start = std::chrono::steady_clock::now();
+        bool ok = writeFileReplacing(item->job.filename, [&](SkWStream* file) {
+            return item->image->writeToStream(file);
+        });
+        item->image.reset();
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->stats.writeSeconds += secondsSince(start);
+        }
+        finish(*item, ok);
     }
+}
+
+// ============================================================================
+// Figure Implementation
+// ============================================================================
+
+Figure::Figure(const FigureConfig& config)
+    : config_(config), resources_(std::make_shared<RenderResources>()),
+      raster_(std::make_unique<RasterState>()) {
+    config_.rows = std::max(config_.rows, 1);
+    config_.columns = std::max(config_.columns, 1);
+    config_.spacing = std::max(config_.spacing, 0);
     
-    // Draw Y label (rotated)
-    if (!config_.yLabel.empty()) {
-        font.setSize(14);
-        canvas->save();
-        canvas->translate(15, config_.height / 2);
-        canvas->rotate(-90);
-        SkRect bounds;
-        font.measureText(config_.yLabel.c_str(), config_.yLabel.length(), 
-                        SkTextEncoding::kUTF8, &bounds);
-        canvas->drawSimpleText(config_.yLabel.c_str(), config_.yLabel.length(), 
-                              SkTextEncoding::kUTF8,
-                              -bounds.width() / 2, 0, font, paint);
-        canvas->restore();
+    size_t threads = resolveThreadCount(config_.renderThreads);
+    if (threads > 1) {
+        pool_ = std::make_unique<ThreadPool>(threads);
+    }
+    for (int i = 0; i < config_.rows * config_.columns; ++i) {
+        panels_.push_back(std::make_unique<Plot>(config_.panelWidth, config_.panelHeight));
     }
 }
 
-bool Plot::render() {
-    setupCanvas();
-    if (!surface_) {
-        return false;
+Figure::~Figure() = default;
+
+Plot& Figure::panel(int row, int column) {
+    row = std::clamp(row, 0, config_.rows - 1);
+    column = std::clamp(column, 0, config_.columns - 1);
+    return *panels_[row * config_.columns + column];
+}
+
+int Figure::getWidth() const {
+    return config_.columns * (config_.panelWidth + config_.spacing) + config_.spacing;
+}
+
+int Figure::getHeight() const {
+    return config_.rows * (config_.panelHeight + config_.spacing) + config_.spacing;
+}
+
+void Figure::warmSeriesCaches() {
+    // Series fill their range, sortedness, smallest positive value and
+    // pyramid caches lazily. One that is shown in several panels fills them
+    // here, once, rather than from several render threads at the same time.
+    for (const auto& panel : panels_) {
+        bool logAxis = panel->config_.xScale == AxisScale::Log10 ||
+                       panel->config_.yScale == AxisScale::Log10;
+        for (const auto& series : panel->series_) {
+            double xMin, xMax, yMin, yMax;
+            series->getRange(xMin, xMax, yMin, yMax);
+            series->isSortedByX();
+            if (logAxis) {
+                double xPositive, yPositive;
+                series->getMinPositive(xPositive, yPositive);
+            }
+            size_t minIndex, maxIndex;
+            if (series->hasPyramid()) {
+                series->findYExtremes(0, 1, minIndex, maxIndex);
+            }
+        }
+    }
+}
+
+bool Figure::render() {
+    if (!raster_->surface) {
+        raster_->surface = SkSurface::MakeRasterN32Premul(getWidth(), getHeight());
+        if (!raster_->surface) {
+            return false;
+        }
     }
     
-    computeDataRange();
-    
-    SkCanvas* canvas = surface_->getCanvas();
-    if (!canvas) {
+    SkPixmap pixels;
+    if (!raster_->surface->peekPixels(&pixels)) {
         return false;
     }
-    
-    drawBackground(canvas);
-    drawGrid(canvas);
-    drawAxes(canvas);
-    
-    // Draw each series with different colors
-    uint32_t colors[] = {
-        0xFF0000FF,  // Blue
-        0xFFFF0000,  // Red
-        0xFF00AA00,  // Green
-        0xFFFF8800,  // Orange
-        0xFF8800FF,  // Purple
-    };
-    
-    for (size_t i = 0; i < series_.size(); ++i) {
-        uint32_t color = colors[i % 5];
-        drawSeries(canvas, series_[i], color);
+    if (config_.spacing > 0) {
+        raster_->surface->getCanvas()->clear(config_.backgroundColor);
     }
     
-    drawLabels(canvas);
+    for (const auto& panel : panels_) {
+        panel->config_.width = config_.panelWidth;
+        panel->config_.height = config_.panelHeight;
+        if (pool_) {
+            panel->config_.renderThreads = 1;  // Panels already run in parallel
+        }
+        panel->resources_ = resources_;
+    }
+    warmSeriesCaches();
     
-    return true;
+    // Panels cover disjoint pixels, so each draws through its own wrapper
+    // surface over its part of the shared buffer
+    std::vector<char> ok(panels_.size(), 0);
+    parallelFor(pool_.get(), panels_.size(), [&](size_t i) {
+        int row = static_cast<int>(i) / config_.columns;
+        int column = static_cast<int>(i) % config_.columns;
+        int left = config_.spacing + column * (config_.panelWidth + config_.spacing);
+        int top = config_.spacing + row * (config_.panelHeight + config_.spacing);
+        ok[i] = panels_[i]->renderTo(pixels.writable_addr(left, top), pixels.rowBytes());
+    });
+    return std::all_of(ok.begin(), ok.end(), [](char panelOk) { return panelOk != 0; });
 }
 
-bool Plot::saveToFile(const std::string& filename) {
-    if (!render()) {
-        return false;
-    }
-    
-    sk_sp<SkImage> image = surface_->makeImageSnapshot();
-    if (!image) {
-        return false;
-    }
-    
-    sk_sp<SkData> data = SkPngEncoder::Encode(nullptr, image.get(), {});
-    if (!data) {
+bool Figure::saveToFile(const std::string& filename, const EncodeOptions& options) {
+    return writeFileReplacing(filename, [&](SkWStream* stream) {
+        return writeImage(stream, filename, options);
+    });
+}
+
+bool Figure::saveToStream(SkWStream& stream, const EncodeOptions& options) {
+    return writeImage(&stream, std::string(), options);
+}
+
+bool Figure::writeImage(SkWStream* stream, const std::string& name, const EncodeOptions& options) {
+    // Panels render into raster subregions; there is no vector equivalent
+    if (isVectorFormat(resolveFormat(name, options.format)) || !render()) {
         return false;
     }
     
-    SkFILEWStream stream(filename.c_str());
-    if (!stream.isValid()) {
+    SkPixmap pixels;
+    if (!raster_->surface->peekPixels(&pixels)) {
         return false;
     }
     
-    return stream.write(data->data(), data->size());
-}
-
-SkCanvas* Plot::getCanvas() {
-    setupCanvas();
-    return surface_ ? surface_->getCanvas() : nullptr;
+    bool ok = encodePixels(stream, pixels, name, options);
+    stream->flush();
+    return ok;
 }
 
 // ============================================================================
@@ -418,6 +5517,22 @@ std::vector<Point> linspace(double start, double end, int num) {
     return points;
 }
 
+DataSeries sampleFunction(const std::function<double(double)>& fn, double start, double end,
+                          int num, const std::string& name) {
+    DataSeries series(name);
+    if (num <= 0) {
+        return series;
+    }
+    
+    double step = num > 1 ? (end - start) / (num - 1) : 0.0;
+    std::vector<double> y(num);
+    for (int i = 0; i < num; ++i) {
+        y[i] = fn(start + i * step);
+    }
+    series.setUniformData(start, step, std::move(y));
+    return series;
+}
+
 bool quickPlot(const std::vector<double>& x, 
                const std::vector<double>& y,
                const std::string& filename,
@@ -427,11 +5542,10 @@ bool quickPlot(const std::vector<double>& x,
     }
     
     Plot plot;
-    DataSeries series("Data");
     
-    for (size_t i = 0; i < x.size(); ++i) {
-        series.addPoint(x[i], y[i]);
-    }
+    // The series only references the caller's vectors, which outlive the plot
+    DataSeries series("Data");
+    series.setView(x, y);
     
     plot.addSeries(series);
     